@@ -0,0 +1,218 @@
+#include "async_multiply.hpp"
+#include "combined_multiply.hpp"
+#include "verification.hpp"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Wake the waiters of a job that has just reached a final state and run its callback
+void notifyFinished(const std::shared_ptr<MultiplyJob>& job) {
+    job->done.notify_all();
+    if (job->options.onComplete) {
+        job->options.onComplete(MultiplyHandle(job));
+    }
+}
+
+// Move a job to a final state, wake its waiters and run its callback
+void finishJob(const std::shared_ptr<MultiplyJob>& job, JobStatus status) {
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->status = status;
+    }
+    notifyFinished(job);
+}
+
+bool isFinal(JobStatus status) {
+    return status == JobStatus::Completed || status == JobStatus::Failed ||
+           status == JobStatus::Cancelled;
+}
+
+} // namespace
+
+// Default options: normal priority on the combined dense engine, no verification
+AsyncOptions::AsyncOptions()
+    : priority(JobPriority::Normal), engine(combinedDenseMultiply), verifySamplingRate(0.0) {}
+
+// Constructor
+MultiplyJob::MultiplyJob(Matrix a, Matrix b, const AsyncOptions& options, unsigned long long sequence)
+    : A(std::move(a)), B(std::move(b)), options(options), sequence(sequence),
+      status(JobStatus::Queued), result(0, 0) {}
+
+// Constructor
+MultiplyHandle::MultiplyHandle(std::shared_ptr<MultiplyJob> job) : job(std::move(job)) {}
+
+// Block until the job reaches a final state
+void MultiplyHandle::wait() const {
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->done.wait(lock, [this] { return isFinal(job->status); });
+}
+
+// Wait, then return the product
+Matrix MultiplyHandle::get() const {
+    wait();
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (job->status == JobStatus::Failed) {
+        std::rethrow_exception(job->error);
+    }
+    if (job->status == JobStatus::Cancelled) {
+        throw std::runtime_error("Multiply job was cancelled.");
+    }
+    return job->result;
+}
+
+// Cancel the job if it has not started yet
+bool MultiplyHandle::cancel() const {
+    {
+        // Check and claim in one critical section, so dispatch() cannot start the job in between
+        std::lock_guard<std::mutex> lock(job->mutex);
+        if (job->status != JobStatus::Queued) {
+            return false;
+        }
+        job->status = JobStatus::Cancelled;
+    }
+    notifyFinished(job);
+    return true;
+}
+
+// Current state of the job
+JobStatus MultiplyHandle::status() const {
+    std::lock_guard<std::mutex> lock(job->mutex);
+    return job->status;
+}
+
+// True once the job has reached a final state
+bool MultiplyHandle::ready() const {
+    return isFinal(status());
+}
+
+// Higher priority first, then submission order
+bool MultiplyScheduler::JobOrder::operator()(const std::shared_ptr<MultiplyJob>& a,
+                                             const std::shared_ptr<MultiplyJob>& b) const {
+    if (a->options.priority != b->options.priority) {
+        return a->options.priority < b->options.priority;
+    }
+    return a->sequence > b->sequence;
+}
+
+// Constructor
+MultiplyScheduler::MultiplyScheduler(ThreadPool& pool, int maxInFlight)
+    : pool(pool), inFlight(0),
+      maxInFlight(maxInFlight > 0 ? maxInFlight : std::max(1, pool.getThreadCount())),
+      nextSequence(0) {}
+
+// Destructor: running jobs reference the scheduler, so wait for them
+MultiplyScheduler::~MultiplyScheduler() {
+    waitIdle();
+}
+
+// Queue A * B
+MultiplyHandle MultiplyScheduler::submit(Matrix A, Matrix B, const AsyncOptions& options) {
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    std::shared_ptr<MultiplyJob> job =
+        std::make_shared<MultiplyJob>(std::move(A), std::move(B), options, nextSequence++);
+    queue.push(job);
+    dispatch();
+    return MultiplyHandle(job);
+}
+
+// Change the number of jobs allowed to run at once
+void MultiplyScheduler::setMaxInFlight(int limit) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    maxInFlight = std::max(1, limit);
+    dispatch();
+}
+
+// Get the number of jobs allowed to run at once
+int MultiplyScheduler::getMaxInFlight() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return maxInFlight;
+}
+
+// Number of jobs currently running
+int MultiplyScheduler::getInFlight() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return inFlight;
+}
+
+// Number of jobs waiting to start (cancelled jobs are dropped lazily, so they
+// may still be counted until they reach the front of the queue)
+int MultiplyScheduler::getQueued() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return static_cast<int>(queue.size());
+}
+
+// Block until no job is queued or running
+void MultiplyScheduler::waitIdle() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    idle.wait(lock, [this] { return queue.empty() && inFlight == 0; });
+}
+
+// Start queued jobs while there is capacity
+void MultiplyScheduler::dispatch() {
+    while (inFlight < maxInFlight && !queue.empty()) {
+        std::shared_ptr<MultiplyJob> job = queue.top();
+        queue.pop();
+        {
+            std::lock_guard<std::mutex> jobLock(job->mutex);
+            if (job->status != JobStatus::Queued) {
+                continue; // Cancelled while waiting
+            }
+            job->status = JobStatus::Running;
+        }
+        ++inFlight;
+        pool.submit([this, job] { runJob(job); });
+    }
+    if (queue.empty() && inFlight == 0) {
+        idle.notify_all();
+    }
+}
+
+// Run one job on a pool worker, then start the next one
+void MultiplyScheduler::runJob(const std::shared_ptr<MultiplyJob>& job) {
+    JobStatus status = JobStatus::Completed;
+    try {
+        Matrix product = job->options.engine(job->A, job->B);
+        if (job->options.verifySamplingRate > 0.0) {
+            VerifyOptions verifyOptions;
+            verifyOptions.samplingRate = job->options.verifySamplingRate;
+            VerifyResult check = verifyProduct(job->A, job->B, product, verifyOptions);
+            if (!check.passed) {
+                std::ostringstream message;
+                message << "Result verification failed at row " << check.worstRow
+                        << " (error " << check.worstError << ", allowed " << check.worstAllowed << ").";
+                throw std::runtime_error(message.str());
+            }
+        }
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->result = std::move(product);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->error = std::current_exception();
+        status = JobStatus::Failed;
+    }
+    job->A = Matrix(0, 0); // Operands are no longer needed once the product exists
+    job->B = Matrix(0, 0);
+    finishJob(job, status);
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    --inFlight;
+    dispatch();
+}
+
+// Process-wide scheduler running on the shared thread pool
+MultiplyScheduler& sharedMultiplyScheduler() {
+    static MultiplyScheduler scheduler(sharedThreadPool());
+    return scheduler;
+}
+
+// Asynchronous A * B on the shared scheduler
+MultiplyHandle multiplyAsync(Matrix A, Matrix B, const AsyncOptions& options) {
+    return sharedMultiplyScheduler().submit(std::move(A), std::move(B), options);
+}
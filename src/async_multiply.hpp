@@ -0,0 +1,128 @@
+#ifndef ASYNC_MULTIPLY_HPP
+#define ASYNC_MULTIPLY_HPP
+
+#include "matrix.hpp"
+#include "thread_pool.hpp"
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+// Engine used to compute an asynchronous product
+typedef std::function<Matrix(const Matrix&, const Matrix&)> MultiplyEngine;
+
+enum class JobPriority { Low, Normal, High };
+
+enum class JobStatus { Queued, Running, Completed, Failed, Cancelled };
+
+class MultiplyHandle;
+
+// Options for a single asynchronous multiply
+struct AsyncOptions {
+    AsyncOptions();
+
+    JobPriority priority;
+    MultiplyEngine engine; // Defaults to combinedDenseMultiply
+    double verifySamplingRate; // Fraction of results spot-checked with verifyProduct (0 disables)
+    std::function<void(const MultiplyHandle&)> onComplete; // Called once the job reaches a final state
+};
+
+// Shared state of one job (owned jointly by its handle and the scheduler)
+struct MultiplyJob {
+    MultiplyJob(Matrix a, Matrix b, const AsyncOptions& options, unsigned long long sequence);
+
+    Matrix A;
+    Matrix B;
+    AsyncOptions options;
+    unsigned long long sequence; // Submission order, for FIFO within a priority
+    JobStatus status;
+    Matrix result;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable done;
+};
+
+// Future-like handle to an asynchronous multiply
+class MultiplyHandle {
+public:
+    explicit MultiplyHandle(std::shared_ptr<MultiplyJob> job);
+
+    // Block until the job reaches a final state
+    void wait() const;
+
+    // Wait, then return the product (rethrows the engine's exception, or
+    // throws std::runtime_error if the job was cancelled)
+    Matrix get() const;
+
+    // Cancel the job if it has not started yet; returns true on success
+    bool cancel() const;
+
+    // Current state of the job
+    JobStatus status() const;
+
+    // True once the job has reached a final state
+    bool ready() const;
+
+private:
+    std::shared_ptr<MultiplyJob> job;
+};
+
+// Queues multiply jobs by priority and feeds them to a thread pool, keeping at
+// most maxInFlight of them running so the pool stays busy without
+// oversubscribing its workers
+class MultiplyScheduler {
+public:
+    // Constructor (maxInFlight <= 0 uses the pool's thread count)
+    explicit MultiplyScheduler(ThreadPool& pool, int maxInFlight = 0);
+
+    // Waits for every submitted job
+    ~MultiplyScheduler();
+
+    MultiplyScheduler(const MultiplyScheduler&) = delete;
+    MultiplyScheduler& operator=(const MultiplyScheduler&) = delete;
+
+    // Queue A * B; the operands are moved or copied into the job
+    MultiplyHandle submit(Matrix A, Matrix B, const AsyncOptions& options = AsyncOptions());
+
+    // Change the number of jobs allowed to run at once
+    void setMaxInFlight(int maxInFlight);
+
+    // Get the number of jobs allowed to run at once
+    int getMaxInFlight() const;
+
+    // Number of jobs currently running
+    int getInFlight() const;
+
+    // Number of jobs waiting to start
+    int getQueued() const;
+
+    // Block until no job is queued or running
+    void waitIdle();
+
+private:
+    struct JobOrder {
+        bool operator()(const std::shared_ptr<MultiplyJob>& a, const std::shared_ptr<MultiplyJob>& b) const;
+    };
+
+    void dispatch(); // Start queued jobs while there is capacity (queueMutex held)
+    void runJob(const std::shared_ptr<MultiplyJob>& job);
+
+    ThreadPool& pool;
+    std::priority_queue<std::shared_ptr<MultiplyJob>, std::vector<std::shared_ptr<MultiplyJob>>, JobOrder> queue;
+    mutable std::mutex queueMutex;
+    std::condition_variable idle;
+    int inFlight;
+    int maxInFlight;
+    unsigned long long nextSequence;
+};
+
+// Process-wide scheduler running on the shared thread pool
+MultiplyScheduler& sharedMultiplyScheduler();
+
+// Asynchronous A * B on the shared scheduler
+MultiplyHandle multiplyAsync(Matrix A, Matrix B, const AsyncOptions& options = AsyncOptions());
+
+#endif // ASYNC_MULTIPLY_HPP
@@ -0,0 +1,368 @@
+#include "bit_matrix.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
+#include <immintrin.h> // For AVX2
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Words per AVX2 register
+const int kRegisterWords = 4;
+
+// Boolean product: rows of C per task, and rows of B per cache block
+const int kBooleanRowBlock = 64;
+const int kBooleanDepthBlock = 512;
+
+// Count product: rows of A and of Bᵀ per tile, and words per depth block
+// (two 32 x 64-word tiles take 32 KB)
+const int kCountTile = 32;
+const int kCountWordBlock = 64;
+
+// Register chunks a byte counter can take before it may overflow (8 bits each)
+const int kByteCounterChunks = 31;
+
+// Words needed for cols bits, rounded up to whole registers
+int paddedWords(int cols) {
+    int needed = (cols + 63) / 64;
+    return (needed + kRegisterWords - 1) / kRegisterWords * kRegisterWords;
+}
+
+// Transpose a 64 x 64 bit block in place (row r = a[r], column c = bit c)
+void transpose64(uint64_t a[64]) {
+    uint64_t mask = 0x00000000FFFFFFFFULL;
+    for (int j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+        for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            uint64_t t = ((a[k] >> j) ^ a[k | j]) & mask;
+            a[k] ^= t << j;
+            a[k | j] ^= t;
+        }
+    }
+}
+
+// C words [w0, w0 + Groups * 4) of row i |= B rows k in [k0, k1) where A(i, k) is set
+template <int Groups>
+void orRowBlock(const BitMatrix& A, const BitMatrix& B, BitMatrix& C, int i, int k0, int k1, int w0) {
+    __m256i acc[Groups];
+    uint64_t* out = C.rowWords(i) + w0;
+    for (int g = 0; g < Groups; ++g) {
+        acc[g] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(out + g * kRegisterWords));
+    }
+    const uint64_t* aRow = A.rowWords(i);
+    for (int kw = k0 / 64; kw * 64 < k1; ++kw) {
+        uint64_t bits = aRow[kw];
+        if (kw * 64 < k0) {
+            bits &= ~0ULL << (k0 - kw * 64);
+        }
+        if (k1 - kw * 64 < 64) {
+            bits &= (1ULL << (k1 - kw * 64)) - 1;
+        }
+        while (bits != 0) {
+            int k = kw * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            const uint64_t* bRow = B.rowWords(k) + w0;
+            for (int g = 0; g < Groups; ++g) {
+                acc[g] = _mm256_or_si256(acc[g],
+                                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bRow + g * kRegisterWords)));
+            }
+        }
+    }
+    for (int g = 0; g < Groups; ++g) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + g * kRegisterWords), acc[g]);
+    }
+}
+
+// Set bits of each byte of v
+inline __m256i popcountBytes(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibble = _mm256_set1_epi8(0x0f);
+    __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, lowNibble));
+    __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibble));
+    return _mm256_add_epi8(lo, hi);
+}
+
+// Sum of the four 64-bit lanes
+inline long long sumLanes(__m256i v) {
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return _mm_cvtsi128_si64(half) + _mm_extract_epi64(half, 1);
+}
+
+// counts of the pairs (a0, a1) x (b0, b1) over words [w0, w1): byte counters
+// are folded into 64-bit sums before they can overflow
+void countPairs(const uint64_t* a0, const uint64_t* a1, const uint64_t* b0, const uint64_t* b1,
+                int w0, int w1, long long counts[4]) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sum00 = zero;
+    __m256i sum01 = zero;
+    __m256i sum10 = zero;
+    __m256i sum11 = zero;
+    for (int w = w0; w < w1;) {
+        int stop = std::min(w1, w + kByteCounterChunks * kRegisterWords);
+        __m256i bytes00 = zero;
+        __m256i bytes01 = zero;
+        __m256i bytes10 = zero;
+        __m256i bytes11 = zero;
+        for (; w < stop; w += kRegisterWords) {
+            __m256i x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a0 + w));
+            __m256i x1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a1 + w));
+            __m256i y0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b0 + w));
+            __m256i y1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b1 + w));
+            bytes00 = _mm256_add_epi8(bytes00, popcountBytes(_mm256_and_si256(x0, y0)));
+            bytes01 = _mm256_add_epi8(bytes01, popcountBytes(_mm256_and_si256(x0, y1)));
+            bytes10 = _mm256_add_epi8(bytes10, popcountBytes(_mm256_and_si256(x1, y0)));
+            bytes11 = _mm256_add_epi8(bytes11, popcountBytes(_mm256_and_si256(x1, y1)));
+        }
+        sum00 = _mm256_add_epi64(sum00, _mm256_sad_epu8(bytes00, zero));
+        sum01 = _mm256_add_epi64(sum01, _mm256_sad_epu8(bytes01, zero));
+        sum10 = _mm256_add_epi64(sum10, _mm256_sad_epu8(bytes10, zero));
+        sum11 = _mm256_add_epi64(sum11, _mm256_sad_epu8(bytes11, zero));
+    }
+    counts[0] += sumLanes(sum00);
+    counts[1] += sumLanes(sum01);
+    counts[2] += sumLanes(sum10);
+    counts[3] += sumLanes(sum11);
+}
+
+} // namespace
+
+// Constructor for an all-zero matrix
+BitMatrix::BitMatrix(int r, int c) : rows(r), cols(c), wordsPerRow(paddedWords(c)) {
+    if (r < 0 || c < 0) {
+        throw std::invalid_argument("Matrix dimensions must not be negative.");
+    }
+    words.assign(static_cast<size_t>(rows) * wordsPerRow, 0);
+}
+
+// Build from a dense matrix or view
+BitMatrix::BitMatrix(const MatrixView& M) : BitMatrix(M.getRows(), M.getCols()) {
+    for (int i = 0; i < rows; ++i) {
+        const double* row = M.data() + i * M.rowStride();
+        uint64_t* out = rowWords(i);
+        for (int j = 0; j < cols; ++j) {
+            if (row[j * M.colStride()] != 0.0) {
+                out[j / 64] |= 1ULL << (j % 64);
+            }
+        }
+    }
+}
+
+// Build from the pattern of a CSR matrix
+BitMatrix::BitMatrix(const CSRMatrix& pattern) : BitMatrix(pattern.getRows(), pattern.getCols()) {
+    for (int i = 0; i < rows; ++i) {
+        uint64_t* out = rowWords(i);
+        for (int p = pattern.rowPtr[i]; p < pattern.rowPtr[i + 1]; ++p) {
+            int j = pattern.colIndices[p];
+            out[j / 64] |= 1ULL << (j % 64);
+        }
+    }
+}
+
+// Convert to a dense matrix of 0.0 and 1.0
+Matrix BitMatrix::toMatrix() const {
+    Matrix result(rows, cols);
+    for (int i = 0; i < rows; ++i) {
+        const uint64_t* in = rowWords(i);
+        double* out = result.rowData(i);
+        for (int w = 0; w < wordsPerRow; ++w) {
+            for (uint64_t bits = in[w]; bits != 0; bits &= bits - 1) {
+                out[w * 64 + __builtin_ctzll(bits)] = 1.0;
+            }
+        }
+    }
+    return result;
+}
+
+// Convert to CSR with value 1.0 at every set bit
+CSRMatrix BitMatrix::toCSR() const {
+    CSRMatrix result(rows, cols);
+    for (int i = 0; i < rows; ++i) {
+        const uint64_t* in = rowWords(i);
+        for (int w = 0; w < wordsPerRow; ++w) {
+            for (uint64_t bits = in[w]; bits != 0; bits &= bits - 1) {
+                result.colIndices.push_back(w * 64 + __builtin_ctzll(bits));
+                result.values.push_back(1.0);
+            }
+        }
+        result.rowPtr[i + 1] = static_cast<int>(result.colIndices.size());
+    }
+    return result;
+}
+
+// Get number of rows
+int BitMatrix::getRows() const {
+    return rows;
+}
+
+// Get number of columns
+int BitMatrix::getCols() const {
+    return cols;
+}
+
+// Get number of words per row
+int BitMatrix::getWordsPerRow() const {
+    return wordsPerRow;
+}
+
+// Get element (i, j)
+bool BitMatrix::get(int i, int j) const {
+    if (i < 0 || i >= rows || j < 0 || j >= cols) {
+        throw std::out_of_range("Matrix index out of range.");
+    }
+    return (rowWords(i)[j / 64] >> (j % 64)) & 1;
+}
+
+// Set element (i, j)
+void BitMatrix::set(int i, int j, bool value) {
+    if (i < 0 || i >= rows || j < 0 || j >= cols) {
+        throw std::out_of_range("Matrix index out of range.");
+    }
+    uint64_t bit = 1ULL << (j % 64);
+    if (value) {
+        rowWords(i)[j / 64] |= bit;
+    } else {
+        rowWords(i)[j / 64] &= ~bit;
+    }
+}
+
+// Number of set bits
+long long BitMatrix::count() const {
+    long long total = 0;
+    for (uint64_t word : words) {
+        total += __builtin_popcountll(word);
+    }
+    return total;
+}
+
+// Transposed copy
+BitMatrix BitMatrix::transpose() const {
+    BitMatrix result(cols, rows);
+    int rowBlocks = (rows + 63) / 64;
+    int colBlocks = (cols + 63) / 64;
+    sharedThreadPool().parallelFor(0, colBlocks, 1, [&](int lo, int hi) {
+        uint64_t block[64];
+        for (int cb = lo; cb < hi; ++cb) {
+            for (int rb = 0; rb < rowBlocks; ++rb) {
+                for (int r = 0; r < 64; ++r) {
+                    int i = rb * 64 + r;
+                    block[r] = i < rows ? rowWords(i)[cb] : 0;
+                }
+                transpose64(block);
+                for (int c = 0; c < 64 && cb * 64 + c < cols; ++c) {
+                    result.rowWords(cb * 64 + c)[rb] = block[c];
+                }
+            }
+        }
+    });
+    return result;
+}
+
+// Boolean (OR-AND) product
+BitMatrix booleanMultiply(const BitMatrix& A, const BitMatrix& B) {
+    TRACE_SCOPE("booleanMultiply");
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+    BitMatrix C(A.getRows(), B.getCols());
+    int words = C.getWordsPerRow();
+    int depth = A.getCols();
+    int rowBlocks = (A.getRows() + kBooleanRowBlock - 1) / kBooleanRowBlock;
+
+    sharedThreadPool().parallelFor(0, rowBlocks, 1, [&](int lo, int hi) {
+        for (int rb = lo; rb < hi; ++rb) {
+            TRACE_SCOPE_ARG("booleanRowBlock", rb);
+            int i0 = rb * kBooleanRowBlock;
+            int i1 = std::min(A.getRows(), i0 + kBooleanRowBlock);
+            for (int k0 = 0; k0 < depth; k0 += kBooleanDepthBlock) {
+                int k1 = std::min(depth, k0 + kBooleanDepthBlock);
+                // Eight registers of words at a time, then four, two and one
+                int w0 = 0;
+                for (; w0 + 8 * kRegisterWords <= words; w0 += 8 * kRegisterWords) {
+                    for (int i = i0; i < i1; ++i) {
+                        orRowBlock<8>(A, B, C, i, k0, k1, w0);
+                    }
+                }
+                if (w0 + 4 * kRegisterWords <= words) {
+                    for (int i = i0; i < i1; ++i) {
+                        orRowBlock<4>(A, B, C, i, k0, k1, w0);
+                    }
+                    w0 += 4 * kRegisterWords;
+                }
+                if (w0 + 2 * kRegisterWords <= words) {
+                    for (int i = i0; i < i1; ++i) {
+                        orRowBlock<2>(A, B, C, i, k0, k1, w0);
+                    }
+                    w0 += 2 * kRegisterWords;
+                }
+                if (w0 < words) {
+                    for (int i = i0; i < i1; ++i) {
+                        orRowBlock<1>(A, B, C, i, k0, k1, w0);
+                    }
+                }
+            }
+        }
+    });
+    return C;
+}
+
+// Count (AND-popcount) product
+Matrix countMultiply(const BitMatrix& A, const BitMatrix& B) {
+    TRACE_SCOPE("countMultiply");
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+    BitMatrix Bt = B.transpose();
+    int rows = A.getRows();
+    int cols = B.getCols();
+    Matrix C(rows, cols);
+    int words = std::min(A.getWordsPerRow(), Bt.getWordsPerRow());
+    int tileRows = (rows + kCountTile - 1) / kCountTile;
+    int tileCols = (cols + kCountTile - 1) / kCountTile;
+
+    sharedThreadPool().parallelFor(0, tileRows * tileCols, 1, [&](int lo, int hi) {
+        long long counts[kCountTile][kCountTile];
+        for (int tile = lo; tile < hi; ++tile) {
+            TRACE_SCOPE_ARG("countTile", tile);
+            int i0 = tile / tileCols * kCountTile;
+            int j0 = tile % tileCols * kCountTile;
+            int i1 = std::min(rows, i0 + kCountTile);
+            int j1 = std::min(cols, j0 + kCountTile);
+            for (int i = 0; i < kCountTile; ++i) {
+                std::fill(counts[i], counts[i] + kCountTile, 0LL);
+            }
+
+            // Odd edge rows pair with themselves and the duplicate is dropped
+            for (int w0 = 0; w0 < words; w0 += kCountWordBlock) {
+                int w1 = std::min(words, w0 + kCountWordBlock);
+                for (int i = i0; i < i1; i += 2) {
+                    const uint64_t* a0 = A.rowWords(i);
+                    const uint64_t* a1 = A.rowWords(std::min(i + 1, i1 - 1));
+                    for (int j = j0; j < j1; j += 2) {
+                        const uint64_t* b0 = Bt.rowWords(j);
+                        const uint64_t* b1 = Bt.rowWords(std::min(j + 1, j1 - 1));
+                        long long pair[4] = {0, 0, 0, 0};
+                        countPairs(a0, a1, b0, b1, w0, w1, pair);
+                        counts[i - i0][j - j0] += pair[0];
+                        if (j + 1 < j1) {
+                            counts[i - i0][j + 1 - j0] += pair[1];
+                        }
+                        if (i + 1 < i1) {
+                            counts[i + 1 - i0][j - j0] += pair[2];
+                            if (j + 1 < j1) {
+                                counts[i + 1 - i0][j + 1 - j0] += pair[3];
+                            }
+                        }
+                    }
+                }
+            }
+
+            for (int i = i0; i < i1; ++i) {
+                double* out = C.rowData(i);
+                for (int j = j0; j < j1; ++j) {
+                    out[j] = static_cast<double>(counts[i - i0][j - j0]);
+                }
+            }
+        }
+    });
+    return C;
+}
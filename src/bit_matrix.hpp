@@ -0,0 +1,75 @@
+#ifndef BIT_MATRIX_HPP
+#define BIT_MATRIX_HPP
+
+#include "csr_matrix.hpp"
+#include "matrix.hpp"
+#include <cstdint>
+#include <vector>
+
+// Bit-packed 0/1 matrix: element (i, j) is bit j % 64 of word j / 64 of row i.
+// Rows are padded with zero bits to a multiple of four words (one AVX2
+// register), so kernels never need a partial word loop.
+class BitMatrix {
+public:
+    // Constructor for an all-zero matrix
+    BitMatrix(int r, int c);
+
+    // Build from a dense matrix or view: non-zero elements become 1
+    explicit BitMatrix(const MatrixView& M);
+
+    // Build from the pattern of a CSR matrix: every stored element becomes 1
+    explicit BitMatrix(const CSRMatrix& pattern);
+
+    // Convert to a dense matrix of 0.0 and 1.0
+    Matrix toMatrix() const;
+
+    // Convert to CSR with value 1.0 at every set bit
+    CSRMatrix toCSR() const;
+
+    // Get number of rows
+    int getRows() const;
+
+    // Get number of columns
+    int getCols() const;
+
+    // Get number of words per row (padding included)
+    int getWordsPerRow() const;
+
+    // Get element (i, j)
+    bool get(int i, int j) const;
+
+    // Set element (i, j)
+    void set(int i, int j, bool value);
+
+    // Number of set bits
+    long long count() const;
+
+    // Transposed copy, built from 64 x 64 bit blocks
+    BitMatrix transpose() const;
+
+    // Words of row i
+    const uint64_t* rowWords(int i) const { return &words[static_cast<size_t>(i) * wordsPerRow]; }
+    uint64_t* rowWords(int i) { return &words[static_cast<size_t>(i) * wordsPerRow]; }
+
+private:
+    int rows;
+    int cols;
+    int wordsPerRow;
+    std::vector<uint64_t> words;
+};
+
+// Boolean (OR-AND) product: C(i, j) = 1 when A(i, k) and B(k, j) for some k.
+// Every set bit of a row of A ORs the matching row of B into the result,
+// eight AVX2 registers of result words at a time, with B cut into row blocks
+// that stay in cache; row blocks of C are spread over the shared thread pool.
+// The result is, for example, one more step of reachability, or the
+// structure of a sparse product.
+BitMatrix booleanMultiply(const BitMatrix& A, const BitMatrix& B);
+
+// Count (AND-popcount) product: C(i, j) = number of k with A(i, k) and B(k, j),
+// e.g. co-occurrence counts. Rows of A are ANDed with rows of Bᵀ and counted
+// with an AVX2 nibble-lookup popcount, 2 x 2 pairs at a time over cache-sized
+// tiles spread over the shared thread pool.
+Matrix countMultiply(const BitMatrix& A, const BitMatrix& B);
+
+#endif // BIT_MATRIX_HPP
@@ -0,0 +1,164 @@
+#include "bsr_matrix.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Minimum fraction of non-zero elements in the stored blocks for a block size to be chosen
+const double kMinBlockFill = 0.5;
+
+// Number of blockSize x blockSize blocks holding at least one non-zero element
+long long countNonZeroBlocks(const Matrix& dense, int blockSize) {
+    int blockCols = (dense.getCols() + blockSize - 1) / blockSize;
+    std::vector<int> marker(blockCols, -1);
+    long long blocks = 0;
+    for (int i = 0; i < dense.getRows(); ++i) {
+        int blockRow = i / blockSize;
+        const double* row = dense.rowData(i);
+        for (int j = 0; j < dense.getCols(); ++j) {
+            if (row[j] != 0.0 && marker[j / blockSize] != blockRow) {
+                marker[j / blockSize] = blockRow;
+                ++blocks;
+            }
+        }
+    }
+    return blocks;
+}
+
+} // namespace
+
+// Constructor for an empty (all-zero) matrix
+BSRMatrix::BSRMatrix(int r, int c, int blockSize)
+    : rows(r), cols(c), blockSize(blockSize) {
+    if (blockSize < 1) {
+        throw std::invalid_argument("BSR block size must be positive.");
+    }
+    blockRowPtr.assign(getBlockRows() + 1, 0);
+}
+
+// Build from a dense matrix
+BSRMatrix::BSRMatrix(const Matrix& dense, int blockSize)
+    : rows(dense.getRows()), cols(dense.getCols()),
+      blockSize(blockSize > 0 ? blockSize : detectBlockSize(dense)) {
+    int b = this->blockSize;
+    int blockRows = getBlockRows();
+    std::vector<int> marker(getBlockCols(), -1);
+    std::vector<int> rowBlocks;
+    blockRowPtr.assign(blockRows + 1, 0);
+
+    for (int I = 0; I < blockRows; ++I) {
+        int rowEnd = std::min((I + 1) * b, rows);
+
+        // Find the non-zero blocks of this block row
+        rowBlocks.clear();
+        for (int i = I * b; i < rowEnd; ++i) {
+            const double* row = dense.rowData(i);
+            for (int j = 0; j < cols; ++j) {
+                if (row[j] != 0.0 && marker[j / b] != I) {
+                    marker[j / b] = I;
+                    rowBlocks.push_back(j / b);
+                }
+            }
+        }
+        std::sort(rowBlocks.begin(), rowBlocks.end());
+
+        // Copy them out
+        size_t base = blockValues.size();
+        blockValues.resize(base + rowBlocks.size() * b * b, 0.0);
+        for (size_t p = 0; p < rowBlocks.size(); ++p) {
+            int J = rowBlocks[p];
+            int colEnd = std::min((J + 1) * b, cols);
+            double* block = &blockValues[base + p * b * b];
+            for (int i = I * b; i < rowEnd; ++i) {
+                const double* row = dense.rowData(i);
+                std::copy(row + J * b, row + colEnd, block + (i - I * b) * b);
+            }
+            blockColIndices.push_back(J);
+        }
+        blockRowPtr[I + 1] = static_cast<int>(blockColIndices.size());
+    }
+}
+
+// Pick the largest block size whose stored blocks are mostly non-zero
+int BSRMatrix::detectBlockSize(const Matrix& dense) {
+    long long nonZeros = 0;
+    for (int i = 0; i < dense.getRows(); ++i) {
+        const double* row = dense.rowData(i);
+        for (int j = 0; j < dense.getCols(); ++j) {
+            if (row[j] != 0.0) {
+                ++nonZeros;
+            }
+        }
+    }
+    if (nonZeros == 0) {
+        return 1;
+    }
+
+    const int candidates[] = {16, 8, 4, 2};
+    for (int b : candidates) {
+        long long blocks = countNonZeroBlocks(dense, b);
+        double fill = static_cast<double>(nonZeros) / (static_cast<double>(blocks) * b * b);
+        if (fill >= kMinBlockFill) {
+            return b;
+        }
+    }
+    return 1;
+}
+
+// Convert back to a dense matrix
+Matrix BSRMatrix::toDense() const {
+    Matrix result(rows, cols);
+    int b = blockSize;
+    for (int I = 0; I < getBlockRows(); ++I) {
+        int rowEnd = std::min((I + 1) * b, rows);
+        for (int p = blockRowPtr[I]; p < blockRowPtr[I + 1]; ++p) {
+            int J = blockColIndices[p];
+            int colEnd = std::min((J + 1) * b, cols);
+            const double* block = blockData(p);
+            for (int i = I * b; i < rowEnd; ++i) {
+                const double* src = block + (i - I * b) * b;
+                std::copy(src, src + (colEnd - J * b), result.rowData(i) + J * b);
+            }
+        }
+    }
+    return result;
+}
+
+// Get number of rows
+int BSRMatrix::getRows() const {
+    return rows;
+}
+
+// Get number of columns
+int BSRMatrix::getCols() const {
+    return cols;
+}
+
+// Get the block edge length
+int BSRMatrix::getBlockSize() const {
+    return blockSize;
+}
+
+// Get number of block rows
+int BSRMatrix::getBlockRows() const {
+    return (rows + blockSize - 1) / blockSize;
+}
+
+// Get number of block columns
+int BSRMatrix::getBlockCols() const {
+    return (cols + blockSize - 1) / blockSize;
+}
+
+// Get number of stored blocks
+int BSRMatrix::getBlockCount() const {
+    return blockRowPtr.back();
+}
+
+// Elements of stored block p
+const double* BSRMatrix::blockData(int p) const {
+    return &blockValues[static_cast<size_t>(p) * blockSize * blockSize];
+}
+
+double* BSRMatrix::blockData(int p) {
+    return &blockValues[static_cast<size_t>(p) * blockSize * blockSize];
+}
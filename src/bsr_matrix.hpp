@@ -0,0 +1,57 @@
+#ifndef BSR_MATRIX_HPP
+#define BSR_MATRIX_HPP
+
+#include "matrix.hpp"
+#include <vector>
+
+// Block Sparse Row matrix: the matrix is cut into blockSize x blockSize blocks
+// and only blocks holding a non-zero element are stored, each one dense and
+// row-major. Block row I owns blocks blockRowPtr[I] .. blockRowPtr[I + 1] with
+// block columns in ascending order. Edge blocks are zero-padded.
+class BSRMatrix {
+public:
+    // Constructor for an empty (all-zero) matrix
+    BSRMatrix(int r, int c, int blockSize);
+
+    // Build from a dense matrix (blockSize 0 picks one with detectBlockSize)
+    explicit BSRMatrix(const Matrix& dense, int blockSize = 0);
+
+    // Largest block size (16, 8, 4, 2 or 1) whose stored blocks are mostly non-zero
+    static int detectBlockSize(const Matrix& dense);
+
+    // Convert back to a dense matrix
+    Matrix toDense() const;
+
+    // Get number of rows
+    int getRows() const;
+
+    // Get number of columns
+    int getCols() const;
+
+    // Get the block edge length
+    int getBlockSize() const;
+
+    // Get number of block rows
+    int getBlockRows() const;
+
+    // Get number of block columns
+    int getBlockCols() const;
+
+    // Get number of stored blocks
+    int getBlockCount() const;
+
+    // Elements of stored block p (blockSize * blockSize, row-major)
+    const double* blockData(int p) const;
+    double* blockData(int p);
+
+    std::vector<int> blockRowPtr;     // Block rows + 1 offsets into blockColIndices
+    std::vector<int> blockColIndices; // Block column of each stored block
+    std::vector<double> blockValues;  // Stored blocks, back to back
+
+private:
+    int rows;
+    int cols;
+    int blockSize;
+};
+
+#endif // BSR_MATRIX_HPP
@@ -0,0 +1,143 @@
+#include "bsr_multiply.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Columns of B and C handled per pass, so the C panel stays in cache while
+// every block of the block row is applied to it
+const int kColumnPanel = 256;
+
+// Per-thread scratch for the block-level Gustavson accumulator
+struct BlockWorkspace {
+    std::vector<int> marker;   // Stamp of the block row that last touched a block column
+    std::vector<int> position; // Output block index of each touched block column
+    std::vector<int> touched;  // Block columns touched by the current block row
+    int stamp = 0;
+
+    void beginRow(int blockCols) {
+        if (static_cast<int>(marker.size()) < blockCols) {
+            marker.resize(blockCols, 0);
+            position.resize(blockCols);
+        }
+        if (stamp == INT_MAX) {
+            std::fill(marker.begin(), marker.end(), 0);
+            stamp = 0;
+        }
+        ++stamp;
+        touched.clear();
+    }
+};
+
+BlockWorkspace& threadBlockWorkspace() {
+    static thread_local BlockWorkspace workspace;
+    return workspace;
+}
+
+// Collect the distinct block columns of block row I of A * B into ws.touched
+void collectBlockColumns(const BSRMatrix& A, const BSRMatrix& B, int I, BlockWorkspace& ws) {
+    ws.beginRow(B.getBlockCols());
+    for (int p = A.blockRowPtr[I]; p < A.blockRowPtr[I + 1]; ++p) {
+        int K = A.blockColIndices[p];
+        for (int q = B.blockRowPtr[K]; q < B.blockRowPtr[K + 1]; ++q) {
+            int J = B.blockColIndices[q];
+            if (ws.marker[J] != ws.stamp) {
+                ws.marker[J] = ws.stamp;
+                ws.touched.push_back(J);
+            }
+        }
+    }
+}
+
+} // namespace
+
+// Block-sparse - dense multiplication
+Matrix bsrDenseMultiply(const BSRMatrix& A, const Matrix& B) {
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
+    int b = A.getBlockSize();
+    int n = B.getCols();
+    Matrix result(A.getRows(), n);
+    if (n == 0) {
+        return result;
+    }
+
+    sharedThreadPool().parallelFor(0, A.getBlockRows(), 1, [&](int lo, int hi) {
+        for (int I = lo; I < hi; ++I) {
+            int m = std::min(b, A.getRows() - I * b);
+            double* cRow = result.rowData(I * b);
+            for (int j0 = 0; j0 < n; j0 += kColumnPanel) {
+                int width = std::min(kColumnPanel, n - j0);
+                for (int p = A.blockRowPtr[I]; p < A.blockRowPtr[I + 1]; ++p) {
+                    int J = A.blockColIndices[p];
+                    int depth = std::min(b, A.getCols() - J * b);
+                    simd_gemm_block(m, width, depth, A.blockData(p), b,
+                                    B.rowData(J * b) + j0, n, cRow + j0, n);
+                }
+            }
+        }
+    });
+
+    return result;
+}
+
+// Block-sparse - block-sparse multiplication
+BSRMatrix bsrBsrMultiply(const BSRMatrix& A, const BSRMatrix& B) {
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+    if (A.getBlockSize() != B.getBlockSize()) {
+        throw std::invalid_argument("BSR block sizes do not match for multiplication.");
+    }
+
+    int b = A.getBlockSize();
+    int blockRows = A.getBlockRows();
+    ThreadPool& pool = sharedThreadPool();
+    BSRMatrix C(A.getRows(), B.getCols(), b);
+
+    // Symbolic phase: number of output blocks in every block row
+    std::vector<int> rowBlocks(blockRows, 0);
+    pool.parallelFor(0, blockRows, 16, [&](int lo, int hi) {
+        BlockWorkspace& ws = threadBlockWorkspace();
+        for (int I = lo; I < hi; ++I) {
+            collectBlockColumns(A, B, I, ws);
+            rowBlocks[I] = static_cast<int>(ws.touched.size());
+        }
+    });
+
+    for (int I = 0; I < blockRows; ++I) {
+        C.blockRowPtr[I + 1] = C.blockRowPtr[I] + rowBlocks[I];
+    }
+    C.blockColIndices.resize(C.getBlockCount());
+    C.blockValues.assign(static_cast<size_t>(C.getBlockCount()) * b * b, 0.0);
+
+    // Numeric phase: accumulate block products into the preallocated output
+    pool.parallelFor(0, blockRows, 1, [&](int lo, int hi) {
+        BlockWorkspace& ws = threadBlockWorkspace();
+        for (int I = lo; I < hi; ++I) {
+            collectBlockColumns(A, B, I, ws);
+            std::sort(ws.touched.begin(), ws.touched.end());
+            for (size_t t = 0; t < ws.touched.size(); ++t) {
+                int out = C.blockRowPtr[I] + static_cast<int>(t);
+                C.blockColIndices[out] = ws.touched[t];
+                ws.position[ws.touched[t]] = out;
+            }
+
+            for (int p = A.blockRowPtr[I]; p < A.blockRowPtr[I + 1]; ++p) {
+                int K = A.blockColIndices[p];
+                for (int q = B.blockRowPtr[K]; q < B.blockRowPtr[K + 1]; ++q) {
+                    double* cBlock = C.blockData(ws.position[B.blockColIndices[q]]);
+                    simd_gemm_block(b, b, b, A.blockData(p), b, B.blockData(q), b, cBlock, b);
+                }
+            }
+        }
+    });
+
+    return C;
+}
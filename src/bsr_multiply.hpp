@@ -0,0 +1,16 @@
+#ifndef BSR_MULTIPLY_HPP
+#define BSR_MULTIPLY_HPP
+
+#include "bsr_matrix.hpp"
+
+// Block-sparse - dense multiplication (C = A * B). Every stored block of A is
+// multiplied against the matching row panel of B with the register-blocked
+// SIMD kernel; block rows are spread over the shared thread pool.
+Matrix bsrDenseMultiply(const BSRMatrix& A, const Matrix& B);
+
+// Block-sparse - block-sparse multiplication (C = A * B, same block size).
+// Two-phase like the CSR engine: a symbolic pass sizes every output block row,
+// then block products are accumulated straight into the preallocated output.
+BSRMatrix bsrBsrMultiply(const BSRMatrix& A, const BSRMatrix& B);
+
+#endif // BSR_MULTIPLY_HPP
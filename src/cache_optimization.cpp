@@ -1,17 +1,39 @@
-#include "matrix.hpp" // Include your matrix class header
+#include "cache_optimization.hpp"
+#include "simd.hpp"       // For the register-blocked tile kernel
+#include "tile_map.hpp"   // For per-tile occupancy
 #include <iostream>   // For debug output
 #include <algorithm>  // For std::min
+#include <stdexcept>
+#include <vector>
 
 // Function to multiply dense matrices using cache optimization (blocking)
-Matrix cache_optimized_multiply_dense_dense(const Matrix& A, const Matrix& B) {
+Matrix cache_optimized_multiply_dense_dense(const MatrixView& A, const MatrixView& B) {
+    return cache_optimized_multiply_dense_dense_with_epilogue(A, B, Epilogue());
+}
+
+// Blocked dense-dense multiplication with a fused epilogue
+Matrix cache_optimized_multiply_dense_dense_with_epilogue(const MatrixView& A, const MatrixView& B,
+                                                          const Epilogue& epilogue) {
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
     int A_rows = A.getRows();
     int A_cols = A.getCols();
     int B_cols = B.getCols();
 
     Matrix result(A_rows, B_cols); // Create a result matrix initialized to zero
+    epilogue.prepare(A_rows, B_cols);
 
     const int blockSize = 64; // Example block size optimized for cache
 
+    // op(A) and op(B) are read through their strides; a transposed B block is
+    // staged row-major first so the inner loop always runs along unit stride
+    long long aRowStride = A.rowStride();
+    long long aColStride = A.colStride();
+    long long bRowStride = B.rowStride();
+    long long bColStride = B.colStride();
+    std::vector<double> staged(bColStride != 1 ? blockSize * blockSize : 0);
+
     for (int i = 0; i < A_rows; i += blockSize) {
         for (int j = 0; j < B_cols; j += blockSize) {
             for (int k = 0; k < A_cols; k += blockSize) {
@@ -19,56 +41,195 @@ Matrix cache_optimized_multiply_dense_dense(const Matrix& A, const Matrix& B) {
                 int j_end = std::min(j + blockSize, B_cols);
                 int k_end = std::min(k + blockSize, A_cols);
 
-                // Multiply the blocks
-                for (int ii = i; ii < i_end; ++ii) {
+                // Rows of the B block: B itself, or the staged copy
+                const double* bBlock = B.data() + k * bRowStride + j;
+                long long bLd = bRowStride;
+                if (bColStride != 1) {
                     for (int jj = j; jj < j_end; ++jj) {
-                        double sum = result.get(ii, jj); // Get current value in result
-
+                        const double* src = B.data() + jj * bColStride; // Read along column jj of op(B)
                         for (int kk = k; kk < k_end; ++kk) {
-                            sum += A.get(ii, kk) * B.get(kk, jj); // Multiply and accumulate
+                            staged[(kk - k) * blockSize + (jj - j)] = src[kk * bRowStride];
                         }
+                    }
+                    bBlock = staged.data();
+                    bLd = blockSize;
+                }
 
-                        result.set(ii, jj, sum); // Update result
+                // Multiply the blocks (each element sums its k terms in ascending order)
+                for (int ii = i; ii < i_end; ++ii) {
+                    const double* aRow = A.data() + ii * aRowStride;
+                    double* cRow = result.rowData(ii);
+                    for (int kk = k; kk < k_end; ++kk) {
+                        double a = aRow[kk * aColStride];
+                        const double* bRow = bBlock + (kk - k) * bLd;
+                        for (int jj = 0; jj < j_end - j; ++jj) {
+                            cRow[j + jj] += a * bRow[jj]; // Multiply and accumulate
+                        }
                     }
                 }
             }
+
+            // The block is final: post-process it while it is still in cache
+            if (!epilogue.empty() && A_rows > 0 && B_cols > 0) {
+                int i_end = std::min(i + blockSize, A_rows);
+                int j_end = std::min(j + blockSize, B_cols);
+                epilogue.apply(i, j, i_end - i, j_end - j, result.rowData(i) + j, B_cols);
+            }
         }
     }
 
     return result; // Return the result matrix
 }
 
-// Function to multiply dense and sparse matrices using cache optimization (blocking)
-Matrix cache_optimized_multiply_dense_sparse(const Matrix& A, const Matrix& B) {
+// Tiles of A or B below this fraction of non-zero elements use the sparse inner kernel
+static const double kSparseTileDensity = 0.25;
+
+// Sparse inner kernel: result tile = result tile add (A tile mul B tile),
+// skipping the elements of A equal to the semiring's zero
+template <class S>
+static void sparse_tile_multiply(const Matrix& A, const Matrix& B, Matrix& result,
+                                 int i, int i_end, int k, int k_end, int j, int j_end) {
+    for (int ii = i; ii < i_end; ++ii) {
+        const double* aRow = A.rowData(ii);
+        double* cRow = result.rowData(ii);
+        for (int kk = k; kk < k_end; ++kk) {
+            double a = aRow[kk];
+            if (a == S::zero()) {
+                continue;
+            }
+            const double* bRow = B.rowData(kk);
+            for (int jj = j; jj < j_end; ++jj) {
+                cRow[jj] = S::add(cRow[jj], S::mul(a, bRow[jj])); // Multiply and accumulate
+            }
+        }
+    }
+}
+
+// Non-zero elements of the low-density tiles of a matrix, kept row by row
+// within each tile so that a kernel can walk just those elements
+struct SparseTileRows {
+    std::vector<int> first;     // Per tile (row-major): offset of its row pointers, or -1
+    std::vector<int> rowPtr;    // Per listed tile: tileSize + 1 offsets into cols and values
+    std::vector<int> cols;      // Column of each element
+    std::vector<double> values; // Value of each element
+};
+
+// List the elements different from S::zero() of every non-empty tile of M
+// below kSparseTileDensity
+template <class S>
+static SparseTileRows list_sparse_tiles(const Matrix& M, const TileMap& map) {
+    SparseTileRows tiles;
+    int tileSize = map.getTileSize();
+    tiles.first.assign(static_cast<size_t>(map.getTileRows()) * map.getTileCols(), -1);
+    for (int tk = 0; tk < map.getTileRows(); ++tk) {
+        int k = tk * tileSize;
+        int k_end = std::min(k + tileSize, M.getRows());
+        for (int tj = 0; tj < map.getTileCols(); ++tj) {
+            if (map.isEmpty(tk, tj) || map.density(tk, tj) >= kSparseTileDensity) {
+                continue;
+            }
+            int j = tj * tileSize;
+            int j_end = std::min(j + tileSize, M.getCols());
+            tiles.first[static_cast<size_t>(tk) * map.getTileCols() + tj] = static_cast<int>(tiles.rowPtr.size());
+            tiles.rowPtr.push_back(static_cast<int>(tiles.cols.size()));
+            for (int kk = k; kk < k + tileSize; ++kk) {
+                if (kk < k_end) {
+                    const double* row = M.rowData(kk);
+                    for (int jj = j; jj < j_end; ++jj) {
+                        if (row[jj] != S::zero()) {
+                            tiles.cols.push_back(jj);
+                            tiles.values.push_back(row[jj]);
+                        }
+                    }
+                }
+                tiles.rowPtr.push_back(static_cast<int>(tiles.cols.size()));
+            }
+        }
+    }
+    return tiles;
+}
+
+// Sparse-B inner kernel: result tile = result tile add (A tile mul B tile),
+// walking only the listed elements of the B tile and skipping the zeros of A
+template <class S>
+static void sparse_b_tile_multiply(const Matrix& A, const SparseTileRows& tilesB, int tile, Matrix& result,
+                                   int i, int i_end, int k, int k_end) {
+    const int* rowPtr = &tilesB.rowPtr[tilesB.first[tile]];
+    const int* cols = tilesB.cols.data();
+    const double* values = tilesB.values.data();
+    for (int ii = i; ii < i_end; ++ii) {
+        const double* aRow = A.rowData(ii);
+        double* cRow = result.rowData(ii);
+        for (int kk = k; kk < k_end; ++kk) {
+            int begin = rowPtr[kk - k];
+            int end = rowPtr[kk - k + 1];
+            double a = aRow[kk];
+            if (begin == end || a == S::zero()) {
+                continue;
+            }
+            for (int p = begin; p < end; ++p) {
+                cRow[cols[p]] = S::add(cRow[cols[p]], S::mul(a, values[p])); // Multiply and accumulate
+            }
+        }
+    }
+}
+
+// Blocked multiplication driven by the tile maps of both operands: (i,k) x (k,j)
+// tile pairs with an empty side are skipped, pairs with a low-density B tile
+// walk that tile's elements, pairs with a low-density A tile skip A's zeros,
+// and the rest use the register-blocked SIMD kernel. A tile is empty when it
+// holds only the semiring's zero, which annihilates mul.
+template <class S>
+static Matrix cache_optimized_multiply_tiled(const Matrix& A, const Matrix& B) {
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
     int A_rows = A.getRows();
     int A_cols = A.getCols();
     int B_cols = B.getCols();
 
     Matrix result(A_rows, B_cols); // Create a result matrix initialized to zero
+    if (S::zero() != 0.0) {
+        for (int i = 0; i < A_rows; ++i) {
+            std::fill(result.rowData(i), result.rowData(i) + B_cols, S::zero());
+        }
+    }
 
     const int blockSize = 64; // Example block size optimized for cache
 
-    for (int i = 0; i < A_rows; i += blockSize) {
-        for (int j = 0; j < B_cols; j += blockSize) {
-            for (int k = 0; k < A_cols; k += blockSize) {
-                int i_end = std::min(i + blockSize, A_rows);
-                int j_end = std::min(j + blockSize, B_cols);
-                int k_end = std::min(k + blockSize, A_cols);
+    TileMap mapA(A, blockSize, S::zero());
+    TileMap mapB(B, blockSize, S::zero());
+    SparseTileRows tilesB = list_sparse_tiles<S>(B, mapB);
 
-                // Multiply the blocks
-                for (int ii = i; ii < i_end; ++ii) {
-                    for (int jj = j; jj < j_end; ++jj) {
-                        double sum = result.get(ii, jj); // Get current value in result
+    for (int ti = 0; ti < mapA.getTileRows(); ++ti) {
+        int i = ti * blockSize;
+        int i_end = std::min(i + blockSize, A_rows);
+        for (int tk = 0; tk < mapA.getTileCols(); ++tk) {
+            if (mapA.isEmpty(ti, tk)) {
+                continue; // Nothing in this tile of A contributes
+            }
+            int k = tk * blockSize;
+            int k_end = std::min(k + blockSize, A_cols);
+            bool denseA = mapA.density(ti, tk) >= kSparseTileDensity;
 
-                        // Only access non-zero elements of sparse matrix B
-                        for (int kk = k; kk < k_end; ++kk) {
-                            if (B.isNonZero(kk, jj)) { // Only check non-zero elements of sparse matrix
-                                sum += A.get(ii, kk) * B.get(kk, jj); // Multiply and accumulate
-                            }
-                        }
+            for (int tj = 0; tj < mapB.getTileCols(); ++tj) {
+                if (mapB.isEmpty(tk, tj)) {
+                    continue; // Nothing in this tile of B contributes
+                }
+                int j = tj * blockSize;
+                int j_end = std::min(j + blockSize, B_cols);
 
-                        result.set(ii, jj, sum); // Update result
-                    }
+                int tileB = tk * mapB.getTileCols() + tj;
+                if (tilesB.first[tileB] >= 0) {
+                    sparse_b_tile_multiply<S>(A, tilesB, tileB, result, i, i_end, k, k_end);
+                } else if (denseA) {
+                    simd_semiring_gemm_block<S>(i_end - i, j_end - j, k_end - k,
+                                                A.rowData(i) + k, A_cols,
+                                                B.rowData(k) + j, B_cols,
+                                                result.rowData(i) + j, B_cols);
+                } else {
+                    sparse_tile_multiply<S>(A, B, result, i, i_end, k, k_end, j, j_end);
                 }
             }
         }
@@ -77,8 +238,38 @@ Matrix cache_optimized_multiply_dense_sparse(const Matrix& A, const Matrix& B) {
     return result; // Return the result matrix
 }
 
+// Function to multiply dense and sparse matrices using cache optimization (blocking)
+Matrix cache_optimized_multiply_dense_sparse(const Matrix& A, const Matrix& B) {
+    return cache_optimized_multiply_tiled<PlusTimes>(A, B);
+}
+
 // Function to multiply sparse matrices using cache optimization (blocking)
 Matrix cache_optimized_multiply_sparse_sparse(const Matrix& A, const Matrix& B) {
+    return cache_optimized_multiply_tiled<PlusTimes>(A, B);
+}
+
+// Tiled multiplication over a semiring
+template <class S>
+Matrix cache_optimized_semiring_multiply(const Matrix& A, const Matrix& B) {
+    return cache_optimized_multiply_tiled<S>(A, B);
+}
+
+// Instantiations for the semirings of semiring.hpp
+template Matrix cache_optimized_semiring_multiply<PlusTimes>(const Matrix&, const Matrix&);
+template Matrix cache_optimized_semiring_multiply<MinPlus>(const Matrix&, const Matrix&);
+template Matrix cache_optimized_semiring_multiply<MaxPlus>(const Matrix&, const Matrix&);
+template Matrix cache_optimized_semiring_multiply<MaxTimes>(const Matrix&, const Matrix&);
+
+// Blocked multiplication with a prepacked B: tiles of A holding no non-zero
+// element are skipped, the others run the packed micro-kernel over every B panel
+Matrix cache_optimized_multiply_packed(const Matrix& A, const PackedMatrix& B) {
+    if (B.getSide() != PackSide::Right) {
+        throw std::invalid_argument("Packed matrix was packed for the other operand.");
+    }
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
     int A_rows = A.getRows();
     int A_cols = A.getCols();
     int B_cols = B.getCols();
@@ -87,28 +278,62 @@ Matrix cache_optimized_multiply_sparse_sparse(const Matrix& A, const Matrix& B)
 
     const int blockSize = 64; // Example block size optimized for cache
 
-    for (int i = 0; i < A_rows; i += blockSize) {
-        for (int j = 0; j < B_cols; j += blockSize) {
-            for (int k = 0; k < A_cols; k += blockSize) {
-                int i_end = std::min(i + blockSize, A_rows);
-                int j_end = std::min(j + blockSize, B_cols);
-                int k_end = std::min(k + blockSize, A_cols);
+    TileMap mapA(A, blockSize);
+    for (int ti = 0; ti < mapA.getTileRows(); ++ti) {
+        int i = ti * blockSize;
+        int i_end = std::min(i + blockSize, A_rows);
+        for (int tk = 0; tk < mapA.getTileCols(); ++tk) {
+            if (mapA.isEmpty(ti, tk)) {
+                continue; // Nothing in this tile of A contributes
+            }
+            int k = tk * blockSize;
+            int k_end = std::min(k + blockSize, A_cols);
+            for (int jp = 0; jp < B.getPanelCount(); ++jp) {
+                int j = jp * PackedMatrix::kPanelCols;
+                simd_gemm_packed_b(i_end - i, std::min(PackedMatrix::kPanelCols, B_cols - j), k_end - k,
+                                   A.rowData(i) + k, A_cols,
+                                   B.panel(jp) + static_cast<size_t>(k) * PackedMatrix::kPanelCols,
+                                   result.rowData(i) + j, B_cols);
+            }
+        }
+    }
 
-                // Multiply the blocks
-                for (int ii = i; ii < i_end; ++ii) {
-                    for (int jj = j; jj < j_end; ++jj) {
-                        double sum = result.get(ii, jj); // Get current value in result
+    return result; // Return the result matrix
+}
 
-                        // Only access non-zero elements of sparse matrices A and B
-                        for (int kk = k; kk < k_end; ++kk) {
-                            if (A.isNonZero(ii, kk) && B.isNonZero(kk, jj)) {
-                                sum += A.get(ii, kk) * B.get(kk, jj); // Multiply and accumulate
-                            }
-                        }
+// Blocked multiplication with a prepacked A: tiles of B holding no non-zero
+// element are skipped, the others run the packed micro-kernel over every A panel
+Matrix cache_optimized_multiply_packed(const PackedMatrix& A, const Matrix& B) {
+    if (A.getSide() != PackSide::Left) {
+        throw std::invalid_argument("Packed matrix was packed for the other operand.");
+    }
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
 
-                        result.set(ii, jj, sum); // Update result
-                    }
-                }
+    int A_rows = A.getRows();
+    int A_cols = A.getCols();
+    int B_cols = B.getCols();
+
+    Matrix result(A_rows, B_cols); // Create a result matrix initialized to zero
+
+    const int blockSize = 64; // Example block size optimized for cache
+
+    TileMap mapB(B, blockSize);
+    for (int tk = 0; tk < mapB.getTileRows(); ++tk) {
+        int k = tk * blockSize;
+        int k_end = std::min(k + blockSize, A_cols);
+        for (int tj = 0; tj < mapB.getTileCols(); ++tj) {
+            if (mapB.isEmpty(tk, tj)) {
+                continue; // Nothing in this tile of B contributes
+            }
+            int j = tj * blockSize;
+            int j_end = std::min(j + blockSize, B_cols);
+            for (int ip = 0; ip < A.getPanelCount(); ++ip) {
+                int i = ip * PackedMatrix::kPanelRows;
+                simd_gemm_packed_a(std::min(PackedMatrix::kPanelRows, A_rows - i), j_end - j, k_end - k,
+                                   A.panel(ip) + static_cast<size_t>(k) * PackedMatrix::kPanelRows,
+                                   B.rowData(k) + j, B_cols, result.rowData(i) + j, B_cols);
             }
         }
     }
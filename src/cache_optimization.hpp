@@ -1,11 +1,30 @@
 #ifndef CACHE_OPTIMIZATION_H
 #define CACHE_OPTIMIZATION_H
 
+#include "epilogue.hpp"
 #include "matrix.hpp"
+#include "packed_matrix.hpp"
+#include "semiring.hpp"
 
 // Function declarations
-Matrix cache_optimized_multiply_dense_dense(const Matrix& A, const Matrix& B);
+Matrix cache_optimized_multiply_dense_dense(const MatrixView& A, const MatrixView& B);
 Matrix cache_optimized_multiply_dense_sparse(const Matrix& A, const Matrix& B);
 Matrix cache_optimized_multiply_sparse_sparse(const Matrix& A, const Matrix& B);
 
+// Blocked dense-dense multiplication running the epilogue on each block of the
+// result once its last depth block is added
+Matrix cache_optimized_multiply_dense_dense_with_epilogue(const MatrixView& A, const MatrixView& B,
+                                                          const Epilogue& epilogue);
+
+// Blocked multiplication with one operand prepacked; empty tiles of the
+// unpacked operand are skipped
+Matrix cache_optimized_multiply_packed(const Matrix& A, const PackedMatrix& B);
+Matrix cache_optimized_multiply_packed(const PackedMatrix& A, const Matrix& B);
+
+// Tiled multiplication over semiring S (see semiring.hpp): tiles holding only
+// S::zero() are skipped, sparse tiles use a scalar kernel and dense ones the
+// semiring SIMD kernel
+template <class S>
+Matrix cache_optimized_semiring_multiply(const Matrix& A, const Matrix& B);
+
 #endif // CACHE_OPTIMIZATION_H
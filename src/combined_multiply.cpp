@@ -0,0 +1,116 @@
+#include "combined_multiply.hpp"
+#include "packed_matrix.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Micro-tile of the kernel
+const int kMicroRows = 4;
+const int kMicroCols = 8;
+
+// Macro-tile sizes: a packed MC x KC block of A fits in L2, a KC x 8 micro-panel
+// of B in L1, and the KC x NC block of B is reused across the rows of the tile
+const int kMacroRows = 128; // MC
+const int kMacroCols = 256; // NC
+const int kDepth = 256;     // KC
+
+// Per-thread packing buffers, grown on first use and kept for later calls
+thread_local std::vector<double> packedA;
+thread_local std::vector<double> packedB;
+
+// The combined engine over semiring S: every tile starts at S::zero() and
+// gathers its depth blocks with S::add
+template <class S>
+Matrix combinedMultiply(const MatrixView& A, const MatrixView& B, const Epilogue& epilogue) {
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
+    int m = A.getRows();
+    int k = A.getCols();
+    int n = B.getCols();
+    Matrix result(m, n);
+    epilogue.prepare(m, n);
+    if (m == 0 || n == 0) {
+        return result;
+    }
+    if (k == 0) {
+        if (S::zero() != 0.0) {
+            std::fill(result.rowData(0), result.rowData(0) + static_cast<size_t>(m) * n, S::zero());
+        }
+        if (!epilogue.empty()) {
+            epilogue.apply(0, 0, m, n, result.rowData(0), n);
+        }
+        return result;
+    }
+
+    int tileRows = (m + kMacroRows - 1) / kMacroRows;
+    int tileCols = (n + kMacroCols - 1) / kMacroCols;
+    sharedThreadPool().parallelFor(0, tileRows * tileCols, 1, [&](int lo, int hi) {
+        for (int tile = lo; tile < hi; ++tile) {
+            TRACE_SCOPE_ARG("macroTile", tile);
+            int i0 = (tile / tileCols) * kMacroRows;
+            int j0 = (tile % tileCols) * kMacroCols;
+            int height = std::min(kMacroRows, m - i0);
+            int width = std::min(kMacroCols, n - j0);
+            if (S::zero() != 0.0) {
+                for (int i = i0; i < i0 + height; ++i) {
+                    std::fill(result.rowData(i) + j0, result.rowData(i) + j0 + width, S::zero());
+                }
+            }
+
+            for (int p0 = 0; p0 < k; p0 += kDepth) {
+                int depth = std::min(kDepth, k - p0);
+                bool lastDepth = p0 + depth == k;
+                packRightPanels(B, p0, depth, j0, width, packedB);
+                packLeftPanels(A, i0, height, p0, depth, packedA);
+
+                // Each B micro-panel stays in L1 while it meets every A panel
+                for (int jr = 0; jr < width; jr += kMicroCols) {
+                    const double* panelB = &packedB[static_cast<size_t>(jr / kMicroCols) * kMicroCols * depth];
+                    int cols = std::min(kMicroCols, width - jr);
+                    for (int ir = 0; ir < height; ir += kMicroRows) {
+                        const double* panelA = &packedA[static_cast<size_t>(ir / kMicroRows) * kMicroRows * depth];
+                        int rows = std::min(kMicroRows, height - ir);
+                        double* tile = result.rowData(i0 + ir) + j0 + jr;
+                        simd_semiring_gemm_packed_ab<S>(rows, cols, depth, panelA, panelB, tile, n);
+                        if (lastDepth && !epilogue.empty()) {
+                            epilogue.apply(i0 + ir, j0 + jr, rows, cols, tile, n);
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    return result;
+}
+
+} // namespace
+
+// Dense-Dense multiplication with threads, cache blocking and SIMD
+Matrix combinedDenseMultiply(const MatrixView& A, const MatrixView& B) {
+    return combinedMultiply<PlusTimes>(A, B, Epilogue());
+}
+
+// Dense-Dense multiplication with threads, cache blocking, SIMD and a fused epilogue
+Matrix combinedDenseMultiplyWithEpilogue(const MatrixView& A, const MatrixView& B, const Epilogue& epilogue) {
+    return combinedMultiply<PlusTimes>(A, B, epilogue);
+}
+
+// Combined engine over a semiring
+template <class S>
+Matrix combinedSemiringMultiply(const MatrixView& A, const MatrixView& B) {
+    return combinedMultiply<S>(A, B, Epilogue());
+}
+
+// Instantiations for the semirings of semiring.hpp
+template Matrix combinedSemiringMultiply<PlusTimes>(const MatrixView&, const MatrixView&);
+template Matrix combinedSemiringMultiply<MinPlus>(const MatrixView&, const MatrixView&);
+template Matrix combinedSemiringMultiply<MaxPlus>(const MatrixView&, const MatrixView&);
+template Matrix combinedSemiringMultiply<MaxTimes>(const MatrixView&, const MatrixView&);
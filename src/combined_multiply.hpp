@@ -0,0 +1,26 @@
+#ifndef COMBINED_MULTIPLY_HPP
+#define COMBINED_MULTIPLY_HPP
+
+#include "epilogue.hpp"
+#include "matrix.hpp"
+#include "semiring.hpp"
+
+// Dense-dense multiplication using threads, cache blocking and SIMD together.
+// The output is cut into macro-tiles that are spread over the shared thread
+// pool; for every depth block a thread packs its slice of A and B into
+// per-thread panel buffers sized for L2 and L1, then runs the 4x8 AVX2
+// micro-kernel over them. Transposed or strided views are read in place while
+// packing, so op(A) and op(B) cost no extra copy.
+Matrix combinedDenseMultiply(const MatrixView& A, const MatrixView& B);
+
+// Combined engine running the epilogue on each 4x8 micro-tile right after its
+// last depth block, while the tile is still in L1
+Matrix combinedDenseMultiplyWithEpilogue(const MatrixView& A, const MatrixView& B, const Epilogue& epilogue);
+
+// Combined engine over semiring S (see semiring.hpp), e.g.
+// combinedSemiringMultiply<MinPlus>(D, D) for one min-plus squaring step of
+// all-pairs shortest paths
+template <class S>
+Matrix combinedSemiringMultiply(const MatrixView& A, const MatrixView& B);
+
+#endif // COMBINED_MULTIPLY_HPP
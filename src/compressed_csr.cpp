@@ -0,0 +1,113 @@
+#include "compressed_csr.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Slack after the last delta, so kernels can always load eight deltas
+const int kIndexPadding = 32;
+
+// Bytes needed for the largest gap of a row
+unsigned char deltaBytes(int largestGap) {
+    if (largestGap < (1 << 8)) {
+        return 1;
+    }
+    if (largestGap < (1 << 16)) {
+        return 2;
+    }
+    return 4;
+}
+
+} // namespace
+
+// Build from CSR
+CompressedCSRMatrix::CompressedCSRMatrix(const CSRMatrix& csr, ValuePrecision precision)
+    : rowPtr(csr.rowPtr), indexPtr(csr.getRows() + 1, 0), firstCol(csr.getRows(), 0),
+      indexBytes(csr.getRows(), 1), rows(csr.getRows()), cols(csr.getCols()), precision(precision) {
+    // Width of every row, then the byte offsets
+    for (int i = 0; i < rows; ++i) {
+        int begin = csr.rowPtr[i];
+        int end = csr.rowPtr[i + 1];
+        int largestGap = 0;
+        for (int p = begin + 1; p < end; ++p) {
+            largestGap = std::max(largestGap, csr.colIndices[p] - csr.colIndices[p - 1]);
+        }
+        if (begin < end) {
+            firstCol[i] = csr.colIndices[begin];
+        }
+        indexBytes[i] = deltaBytes(largestGap);
+        indexPtr[i + 1] = indexPtr[i] + (end - begin) * indexBytes[i];
+    }
+
+    indexData.assign(indexPtr[rows] + kIndexPadding, 0);
+    for (int i = 0; i < rows; ++i) {
+        unsigned char* out = indexData.data() + indexPtr[i];
+        for (int p = csr.rowPtr[i]; p < csr.rowPtr[i + 1]; ++p) {
+            unsigned delta = p == csr.rowPtr[i] ? 0u : static_cast<unsigned>(csr.colIndices[p] - csr.colIndices[p - 1]);
+            std::memcpy(out, &delta, indexBytes[i]); // Little-endian: the low bytes come first
+            out += indexBytes[i];
+        }
+    }
+
+    if (precision == ValuePrecision::Double) {
+        values = csr.values;
+    } else {
+        floatValues.assign(csr.values.begin(), csr.values.end());
+    }
+}
+
+// Convert back to CSR
+CSRMatrix CompressedCSRMatrix::toCSR() const {
+    CSRMatrix result(rows, cols);
+    result.rowPtr = rowPtr;
+    result.colIndices.resize(getNonZeros());
+    for (int i = 0; i < rows; ++i) {
+        const unsigned char* in = indexData.data() + indexPtr[i];
+        int col = firstCol[i];
+        for (int p = rowPtr[i]; p < rowPtr[i + 1]; ++p) {
+            unsigned delta = 0;
+            std::memcpy(&delta, in, indexBytes[i]);
+            in += indexBytes[i];
+            col += static_cast<int>(delta);
+            result.colIndices[p] = col;
+        }
+    }
+    if (precision == ValuePrecision::Double) {
+        result.values = values;
+    } else {
+        result.values.assign(floatValues.begin(), floatValues.end());
+    }
+    return result;
+}
+
+// Get number of rows
+int CompressedCSRMatrix::getRows() const {
+    return rows;
+}
+
+// Get number of columns
+int CompressedCSRMatrix::getCols() const {
+    return cols;
+}
+
+// Get number of stored elements
+int CompressedCSRMatrix::getNonZeros() const {
+    return rowPtr[rows];
+}
+
+// Get the value precision
+ValuePrecision CompressedCSRMatrix::getPrecision() const {
+    return precision;
+}
+
+// Bytes a product streams
+size_t CompressedCSRMatrix::getStoredBytes() const {
+    return sizeof(int) * (rowPtr.size() + indexPtr.size() + firstCol.size()) + indexBytes.size() +
+           indexPtr[rows] + sizeof(double) * values.size() + sizeof(float) * floatValues.size();
+}
+
+// Bytes a CSR product streams
+size_t csrStoredBytes(const CSRMatrix& csr) {
+    return sizeof(int) * (csr.rowPtr.size() + csr.colIndices.size()) + sizeof(double) * csr.values.size();
+}
@@ -0,0 +1,58 @@
+#ifndef COMPRESSED_CSR_HPP
+#define COMPRESSED_CSR_HPP
+
+#include "csr_matrix.hpp"
+#include <cstddef>
+#include <vector>
+
+// Precision of the stored values (products always accumulate in double)
+enum class ValuePrecision {
+    Double,
+    Float // Half the value bytes, about 7 significant digits
+};
+
+// CSR with compressed column indices, for bandwidth-bound SpMV and SpMM.
+// Each row stores its first column, then one delta per element (the first is
+// 0) in the narrowest of 1, 2 or 4 bytes that holds the row's largest gap.
+// Rows are decoded eight deltas at a time with a SIMD prefix sum.
+class CompressedCSRMatrix {
+public:
+    // Build from CSR
+    explicit CompressedCSRMatrix(const CSRMatrix& csr, ValuePrecision precision = ValuePrecision::Double);
+
+    // Convert back to CSR (values are rounded when stored as float)
+    CSRMatrix toCSR() const;
+
+    // Get number of rows
+    int getRows() const;
+
+    // Get number of columns
+    int getCols() const;
+
+    // Get number of stored elements
+    int getNonZeros() const;
+
+    // Get the value precision
+    ValuePrecision getPrecision() const;
+
+    // Bytes of all arrays a product streams (row arrays, deltas and values)
+    size_t getStoredBytes() const;
+
+    std::vector<int> rowPtr;                // rows + 1 offsets into the values
+    std::vector<int> indexPtr;              // rows + 1 byte offsets into indexData
+    std::vector<int> firstCol;              // Column of the first element of each row
+    std::vector<unsigned char> indexBytes;  // Bytes per delta of each row (1, 2 or 4)
+    std::vector<unsigned char> indexData;   // Deltas of every row, little-endian, plus padding
+    std::vector<double> values;             // Values when precision is Double
+    std::vector<float> floatValues;         // Values when precision is Float
+
+private:
+    int rows;
+    int cols;
+    ValuePrecision precision;
+};
+
+// Bytes of the arrays a CSR product streams, for comparison
+size_t csrStoredBytes(const CSRMatrix& csr);
+
+#endif // COMPRESSED_CSR_HPP
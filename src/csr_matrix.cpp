@@ -0,0 +1,50 @@
+#include "csr_matrix.hpp"
+#include <algorithm>
+
+// Constructor for an empty (all-zero) matrix
+CSRMatrix::CSRMatrix(int r, int c) : rowPtr(r + 1, 0), rows(r), cols(c) {}
+
+// Build from the non-zero elements of a dense matrix
+CSRMatrix::CSRMatrix(const MatrixView& dense, double zero)
+    : rowPtr(dense.getRows() + 1, 0), rows(dense.getRows()), cols(dense.getCols()) {
+    for (int i = 0; i < rows; ++i) {
+        const double* row = dense.data() + i * dense.rowStride();
+        for (int j = 0; j < cols; ++j) {
+            double value = row[j * dense.colStride()];
+            if (value != zero) {
+                colIndices.push_back(j);
+                values.push_back(value);
+            }
+        }
+        rowPtr[i + 1] = static_cast<int>(colIndices.size());
+    }
+}
+
+// Convert back to a dense matrix
+Matrix CSRMatrix::toDense(double zero) const {
+    Matrix result(rows, cols);
+    for (int i = 0; i < rows; ++i) {
+        if (zero != 0.0) {
+            std::fill(result.rowData(i), result.rowData(i) + cols, zero);
+        }
+        for (int p = rowPtr[i]; p < rowPtr[i + 1]; ++p) {
+            result.set(i, colIndices[p], values[p]);
+        }
+    }
+    return result;
+}
+
+// Get number of rows
+int CSRMatrix::getRows() const {
+    return rows;
+}
+
+// Get number of columns
+int CSRMatrix::getCols() const {
+    return cols;
+}
+
+// Get number of stored elements
+int CSRMatrix::getNonZeros() const {
+    return rowPtr[rows];
+}
@@ -0,0 +1,39 @@
+#ifndef CSR_MATRIX_HPP
+#define CSR_MATRIX_HPP
+
+#include "matrix.hpp"
+#include <vector>
+
+// Compressed Sparse Row matrix: row i owns the entries
+// colIndices/values[rowPtr[i] .. rowPtr[i + 1]), with columns in ascending order.
+class CSRMatrix {
+public:
+    // Constructor for an empty (all-zero) matrix
+    CSRMatrix(int r, int c);
+
+    // Build from the non-zero elements of a dense matrix or view; zero names
+    // the value left out (a semiring's zero, e.g. +inf for min-plus)
+    explicit CSRMatrix(const MatrixView& dense, double zero = 0.0);
+
+    // Convert back to a dense matrix, with missing elements set to zero
+    Matrix toDense(double zero = 0.0) const;
+
+    // Get number of rows
+    int getRows() const;
+
+    // Get number of columns
+    int getCols() const;
+
+    // Get number of stored elements
+    int getNonZeros() const;
+
+    std::vector<int> rowPtr;      // rows + 1 offsets into colIndices/values
+    std::vector<int> colIndices;  // Column of each stored element
+    std::vector<double> values;   // Value of each stored element
+
+private:
+    int rows;
+    int cols;
+};
+
+#endif // CSR_MATRIX_HPP
@@ -0,0 +1,147 @@
+#include "epilogue.hpp"
+#include <immintrin.h> // For AVX2
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// sqrt(2 / pi), for the tanh form of GELU
+const double kGeluScale = 0.7978845608028654;
+
+} // namespace
+
+// x = alpha * x
+Epilogue& Epilogue::scale(double alpha) {
+    return add(Kind::Scale, alpha);
+}
+
+// x += values[column]
+Epilogue& Epilogue::bias(const std::vector<double>& values) {
+    add(Kind::Bias);
+    stages.back().values = values;
+    return *this;
+}
+
+// x = max(x, 0)
+Epilogue& Epilogue::relu() {
+    return add(Kind::Relu);
+}
+
+// x = GELU(x)
+Epilogue& Epilogue::gelu() {
+    return add(Kind::Gelu);
+}
+
+// x = min(max(x, lo), hi)
+Epilogue& Epilogue::clamp(double lo, double hi) {
+    if (lo > hi) {
+        throw std::invalid_argument("Clamp bounds are reversed.");
+    }
+    return add(Kind::Clamp, lo, hi);
+}
+
+// Copy the values at this point to out as floats
+Epilogue& Epilogue::toFloat(std::vector<float>& out) {
+    add(Kind::ToFloat);
+    stages.back().out = &out;
+    return *this;
+}
+
+// True when no stage was added
+bool Epilogue::empty() const {
+    return stages.empty();
+}
+
+// Check the stages against the shape of the result
+void Epilogue::prepare(int rows, int cols) const {
+    for (const Stage& stage : stages) {
+        if (stage.kind == Kind::Bias && static_cast<int>(stage.values.size()) != cols) {
+            throw std::invalid_argument("Bias length does not match the result columns.");
+        }
+        if (stage.kind == Kind::ToFloat) {
+            stage.out->assign(static_cast<size_t>(rows) * cols, 0.0f);
+        }
+    }
+    resultCols = cols;
+}
+
+// Run the stages on one block of the result, one row of the block at a time
+void Epilogue::apply(int row0, int col0, int rows, int cols, double* C, int ldc) const {
+    int vecCols = cols - cols % 4;
+    for (const Stage& stage : stages) {
+        for (int r = 0; r < rows; ++r) {
+            double* c = C + static_cast<size_t>(r) * ldc;
+            switch (stage.kind) {
+            case Kind::Scale: {
+                __m256d alpha = _mm256_set1_pd(stage.a);
+                for (int j = 0; j < vecCols; j += 4) {
+                    _mm256_storeu_pd(c + j, _mm256_mul_pd(alpha, _mm256_loadu_pd(c + j)));
+                }
+                for (int j = vecCols; j < cols; ++j) {
+                    c[j] *= stage.a;
+                }
+                break;
+            }
+            case Kind::Bias: {
+                const double* b = stage.values.data() + col0;
+                for (int j = 0; j < vecCols; j += 4) {
+                    _mm256_storeu_pd(c + j, _mm256_add_pd(_mm256_loadu_pd(c + j), _mm256_loadu_pd(b + j)));
+                }
+                for (int j = vecCols; j < cols; ++j) {
+                    c[j] += b[j];
+                }
+                break;
+            }
+            case Kind::Relu: {
+                __m256d zero = _mm256_setzero_pd();
+                for (int j = 0; j < vecCols; j += 4) {
+                    _mm256_storeu_pd(c + j, _mm256_max_pd(zero, _mm256_loadu_pd(c + j)));
+                }
+                for (int j = vecCols; j < cols; ++j) {
+                    c[j] = std::max(c[j], 0.0);
+                }
+                break;
+            }
+            case Kind::Gelu:
+                for (int j = 0; j < cols; ++j) {
+                    double x = c[j];
+                    c[j] = 0.5 * x * (1.0 + std::tanh(kGeluScale * (x + 0.044715 * x * x * x)));
+                }
+                break;
+            case Kind::Clamp: {
+                __m256d lo = _mm256_set1_pd(stage.a);
+                __m256d hi = _mm256_set1_pd(stage.b);
+                for (int j = 0; j < vecCols; j += 4) {
+                    _mm256_storeu_pd(c + j, _mm256_min_pd(hi, _mm256_max_pd(lo, _mm256_loadu_pd(c + j))));
+                }
+                for (int j = vecCols; j < cols; ++j) {
+                    c[j] = std::min(std::max(c[j], stage.a), stage.b);
+                }
+                break;
+            }
+            case Kind::ToFloat: {
+                float* out = stage.out->data() + static_cast<size_t>(row0 + r) * resultCols + col0;
+                for (int j = 0; j < vecCols; j += 4) {
+                    _mm_storeu_ps(out + j, _mm256_cvtpd_ps(_mm256_loadu_pd(c + j)));
+                }
+                for (int j = vecCols; j < cols; ++j) {
+                    out[j] = static_cast<float>(c[j]);
+                }
+                break;
+            }
+            }
+        }
+    }
+}
+
+// Append a stage
+Epilogue& Epilogue::add(Kind kind, double a, double b) {
+    Stage stage;
+    stage.kind = kind;
+    stage.a = a;
+    stage.b = b;
+    stage.out = nullptr;
+    stages.push_back(stage);
+    return *this;
+}
@@ -0,0 +1,64 @@
+#ifndef EPILOGUE_HPP
+#define EPILOGUE_HPP
+
+#include <vector>
+
+// Post-processing fused into a multiply: the stages run, in the order they
+// were added, on each block of the result as soon as it is final, while it is
+// still in registers or L1, instead of as separate passes over the whole
+// result. Stages are added with the chaining methods:
+//
+//     std::vector<float> out;
+//     Epilogue e;
+//     e.scale(0.5).bias(b).gelu().toFloat(out);
+//     Matrix C = combinedDenseMultiplyWithEpilogue(A, B, e);
+class Epilogue {
+public:
+    // x = alpha * x
+    Epilogue& scale(double alpha);
+
+    // x += values[column] (one value per column of the result)
+    Epilogue& bias(const std::vector<double>& values);
+
+    // x = max(x, 0)
+    Epilogue& relu();
+
+    // x = GELU(x) (tanh approximation)
+    Epilogue& gelu();
+
+    // x = min(max(x, lo), hi)
+    Epilogue& clamp(double lo, double hi);
+
+    // Also write the values at this point to out as floats (row-major, resized
+    // to the shape of the result when the multiply starts)
+    Epilogue& toFloat(std::vector<float>& out);
+
+    // True when no stage was added
+    bool empty() const;
+
+    // Check the stages against the shape of the result and size the float
+    // outputs (engines call this once before computing)
+    void prepare(int rows, int cols) const;
+
+    // Run the stages on the block of rows x cols elements at (row0, col0) of
+    // the result; C points at that element and has leading dimension ldc
+    void apply(int row0, int col0, int rows, int cols, double* C, int ldc) const;
+
+private:
+    enum class Kind { Scale, Bias, Relu, Gelu, Clamp, ToFloat };
+
+    struct Stage {
+        Kind kind;
+        double a;
+        double b;
+        std::vector<double> values;
+        std::vector<float>* out;
+    };
+
+    Epilogue& add(Kind kind, double a = 0.0, double b = 0.0);
+
+    std::vector<Stage> stages;
+    mutable int resultCols = 0; // Row length of the float outputs, set by prepare()
+};
+
+#endif // EPILOGUE_HPP
@@ -1,4 +1,9 @@
 #include "experimental_multithreading.hpp"
+#include "csr_matrix.hpp"
+#include "row_partition.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <atomic>
 #include <thread>
 #include <vector>
 #include <iostream>
@@ -12,7 +17,8 @@ int getUserThreadCount() {
 }
 
 // Function to multiply a block of rows of A with B (for dense-dense)
-void experimentalMultiplyRowBlock(const Matrix& A, const Matrix& B, Matrix& result, int startRow, int endRow) {
+void experimentalMultiplyRowBlock(const MatrixView& A, const MatrixView& B, Matrix& result, int startRow, int endRow) {
+    TRACE_SCOPE_ARG("rowBlock", startRow);
     for (int row = startRow; row < endRow; ++row) {
         for (int col = 0; col < B.getCols(); ++col) {
             double sum = 0.0;
@@ -25,12 +31,13 @@ void experimentalMultiplyRowBlock(const Matrix& A, const Matrix& B, Matrix& resu
 }
 
 // Experimental Mode: Multithreaded multiplication for Dense-Dense
-Matrix experimentalDenseDenseMultiply(const Matrix& A, const Matrix& B) {
+Matrix experimentalDenseDenseMultiply(const MatrixView& A, const MatrixView& B) {
     int rows = A.getRows();
     int cols = B.getCols();
     Matrix result(rows, cols);
 
     int numThreads = getUserThreadCount();
+    TRACE_SCOPE("rowBlocks"); // From here on, so the prompt is not timed
     std::vector<std::thread> threads;
 
     // Calculate the block size per thread
@@ -39,6 +46,7 @@ Matrix experimentalDenseDenseMultiply(const Matrix& A, const Matrix& B) {
 
     int startRow = 0;
     for (int i = 0; i < numThreads; ++i) {
+        TRACE_SCOPE("spawnThread");
         int endRow = startRow + blockSize;
         if (i < remainder) {  // Distribute remainder rows
             endRow++;
@@ -49,94 +57,135 @@ Matrix experimentalDenseDenseMultiply(const Matrix& A, const Matrix& B) {
 
     // Join all threads
     for (auto& t : threads) {
+        TRACE_SCOPE("joinThread");
         t.join();
     }
 
     return result;
 }
 
-// Function to multiply a block of rows of A with B (for dense-sparse)
-void experimentalMultiplyRowBlockSparse(const Matrix& A, const Matrix& B, Matrix& result, int startRow, int endRow) {
-    for (int row = startRow; row < endRow; ++row) {
-        for (int col = 0; col < B.getCols(); ++col) {
-            double sum = 0.0;
-            for (int k = 0; k < A.getCols(); ++k) {
-                sum += A.get(row, k) * B.get(k, col);
+// Function to run the parts of a row partition on numThreads threads, each
+// thread taking the next unclaimed part, then merge the split rows
+void experimentalRunPartition(RowPartition& partition, Matrix& result, const RowKernel& kernel, int numThreads) {
+    std::atomic<int> nextPart(0);
+    std::vector<std::thread> threads;
+    numThreads = std::max(1, numThreads);
+
+    for (int i = 0; i < numThreads; ++i) {
+        TRACE_SCOPE("spawnThread");
+        threads.emplace_back([&] {
+            for (int p = nextPart++; p < partition.getPartCount(); p = nextPart++) {
+                TRACE_SCOPE_ARG("rowBlock", partition.getPart(p).beginRow);
+                partition.runPart(p, result, kernel);
             }
-            result.set(row, col, sum);
+        });
+    }
+
+    for (auto& t : threads) {
+        TRACE_SCOPE("joinThread");
+        t.join();
+    }
+
+    partition.merge(result);
+}
+
+// Function to add the non-zero elements [beginUnit, endUnit) of a row of A,
+// each times its row of B, to out (for dense-sparse)
+void experimentalMultiplyRowSparse(const Matrix& A, const Matrix& B, int row, long long beginUnit, long long endUnit,
+                                   double* out) {
+    const double* aRow = A.rowData(row);
+    long long unit = 0;
+    for (int k = 0; k < A.getCols() && unit < endUnit; ++k) {
+        if (aRow[k] == 0.0) {
+            continue;
+        }
+        if (unit++ < beginUnit) {
+            continue;
+        }
+        const double* bRow = B.rowData(k);
+        for (int col = 0; col < B.getCols(); ++col) {
+            out[col] += aRow[k] * bRow[col];
         }
     }
 }
 
-// Experimental Mode: Dense-Sparse multiplication
+// Experimental Mode: Dense-Sparse multiplication. Rows are split into ranges
+// with the same number of non-zero elements of A rather than the same number
+// of rows, and rows heavier than a range are shared between threads.
 Matrix experimentalDenseSparseMultiply(const Matrix& A, const Matrix& B) {
     int rows = A.getRows();
     int cols = B.getCols();
     Matrix result(rows, cols);
 
     int numThreads = getUserThreadCount();
-    std::vector<std::thread> threads;
-
-    int blockSize = rows / numThreads;
-    int remainder = rows % numThreads;
-
-    int startRow = 0;
-    for (int i = 0; i < numThreads; ++i) {
-        int endRow = startRow + blockSize;
-        if (i < remainder) {
-            endRow++;
+    TRACE_SCOPE("rowBlocks"); // From here on, so the prompt is not timed
+
+    // Work of a row: its non-zero elements (each one costs a pass over a row of B)
+    std::vector<long long> rowWork(rows, 0);
+    for (int i = 0; i < rows; ++i) {
+        const double* aRow = A.rowData(i);
+        for (int k = 0; k < A.getCols(); ++k) {
+            rowWork[i] += aRow[k] != 0.0;
         }
-        threads.emplace_back(experimentalMultiplyRowBlockSparse, std::ref(A), std::ref(B), std::ref(result), startRow, endRow);
-        startRow = endRow;
     }
 
-    for (auto& t : threads) {
-        t.join();
-    }
+    RowPartition partition(rowWork, numThreads);
+    experimentalRunPartition(partition, result, [&](int row, long long beginUnit, long long endUnit, double* out) {
+        experimentalMultiplyRowSparse(A, B, row, beginUnit, endUnit, out);
+    }, numThreads);
 
     return result;
 }
 
-// Function to multiply a block of rows of A with B (for sparse-sparse)
-void experimentalMultiplyRowBlockSparseSparse(const Matrix& A, const Matrix& B, Matrix& result, int startRow, int endRow) {
-    for (int row = startRow; row < endRow; ++row) {
-        for (int col = 0; col < B.getCols(); ++col) {
-            double sum = 0.0;
-            for (int k = 0; k < A.getCols(); ++k) {
-                if (A.get(row, k) != 0 && B.get(k, col) != 0) {  // Only compute if both are non-zero
-                    sum += A.get(row, k) * B.get(k, col);
-                }
+// Function to add the products of a row of A with B (in CSR) whose flops fall
+// in [beginUnit, endUnit) to out (for sparse-sparse). Each non-zero A(row, k)
+// owns the flops of row k of B and belongs to the piece where they start.
+void experimentalMultiplyRowSparseSparse(const Matrix& A, const CSRMatrix& B, int row, long long beginUnit,
+                                         long long endUnit, double* out) {
+    const double* aRow = A.rowData(row);
+    long long unit = 0;
+    for (int k = 0; k < A.getCols() && unit < endUnit; ++k) {
+        if (aRow[k] == 0.0) {  // Only compute if both are non-zero
+            continue;
+        }
+        int length = B.rowPtr[k + 1] - B.rowPtr[k];
+        if (unit >= beginUnit) {
+            for (int q = B.rowPtr[k]; q < B.rowPtr[k + 1]; ++q) {
+                out[B.colIndices[q]] += aRow[k] * B.values[q];
             }
-            result.set(row, col, sum);
         }
+        unit += length;
     }
 }
 
-// Experimental Mode: Sparse-Sparse multiplication
+// Experimental Mode: Sparse-Sparse multiplication. Rows are split into ranges
+// with the same estimated flops, and rows heavier than a range are shared
+// between threads.
 Matrix experimentalSparseSparseMultiply(const Matrix& A, const Matrix& B) {
     int rows = A.getRows();
     int cols = B.getCols();
     Matrix result(rows, cols);
 
     int numThreads = getUserThreadCount();
-    std::vector<std::thread> threads;
+    TRACE_SCOPE("rowBlocks"); // From here on, so the prompt is not timed
 
-    int blockSize = rows / numThreads;
-    int remainder = rows % numThreads;
+    CSRMatrix sparseB(B);
 
-    int startRow = 0;
-    for (int i = 0; i < numThreads; ++i) {
-        int endRow = startRow + blockSize;
-        if (i < remainder) {
-            endRow++;
+    // Work of a row: one multiply-add per (A(i,k), B(k,j)) pair of non-zeros
+    std::vector<long long> rowWork(rows, 0);
+    for (int i = 0; i < rows; ++i) {
+        const double* aRow = A.rowData(i);
+        for (int k = 0; k < A.getCols(); ++k) {
+            if (aRow[k] != 0.0) {
+                rowWork[i] += sparseB.rowPtr[k + 1] - sparseB.rowPtr[k];
+            }
         }
-        threads.emplace_back(experimentalMultiplyRowBlockSparseSparse, std::ref(A), std::ref(B), std::ref(result), startRow, endRow);
-        startRow = endRow;
     }
 
-    for (auto& t : threads) {
-        t.join();
-    }
+    RowPartition partition(rowWork, numThreads);
+    experimentalRunPartition(partition, result, [&](int row, long long beginUnit, long long endUnit, double* out) {
+        experimentalMultiplyRowSparseSparse(A, sparseB, row, beginUnit, endUnit, out);
+    }, numThreads);
 
     return result;
 }
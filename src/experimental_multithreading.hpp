@@ -5,7 +5,7 @@
 #include "matrix.hpp"
 
 // Function declarations
-Matrix experimentalDenseDenseMultiply(const Matrix& A, const Matrix& B);
+Matrix experimentalDenseDenseMultiply(const MatrixView& A, const MatrixView& B);
 Matrix experimentalDenseSparseMultiply(const Matrix& A, const Matrix& B);
 Matrix experimentalSparseSparseMultiply(const Matrix& A, const Matrix& B);
 
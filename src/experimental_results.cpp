@@ -1,4 +1,5 @@
 #include <iostream>
+#include <string>
 #include <chrono>
 #include <papi.h> // Include PAPI header
 #include <sys/resource.h>
@@ -18,8 +19,8 @@ void runExperimentalResults() {
     }
 
     // Prepare table headers
-    std::cout << "Matrix Size | Sparsity | Dense-Dense Time (s) | Dense-Sparse Time (s) | Sparse-Sparse Time (s) | Cache Misses | Peak Memory (KB)\n";
-    std::cout << "--------------------------------------------------------------------------------------------\n";
+    std::cout << "Matrix Size | Sparsity | Dense-Dense Time (s) | Dense-Sparse Time (s) | Sparse-Sparse Time (s) | Cache Misses | dTLB Misses | Peak Memory (KB)\n";
+    std::cout << "----------------------------------------------------------------------------------------------------------\n";
 
     // Iterate over matrix sizes and sparsities
     for (int size : matrixSizes) {
@@ -31,7 +32,7 @@ void runExperimentalResults() {
             A.fillRandom(sparsity);
             B.fillRandom(sparsity);
 
-            long long cacheMisses[1]; // Array to hold the number of cache misses
+            long long cacheMisses[2] = {0, 0}; // L1 data cache misses and dTLB misses
             int EventSet = PAPI_NULL; // Initialize PAPI Event Set
 
             // Create the event set
@@ -46,6 +47,9 @@ void runExperimentalResults() {
                 return;
             }
 
+            // Add the data TLB miss event when the CPU exposes it (counted in slot 1)
+            bool countTlbMisses = PAPI_add_event(EventSet, PAPI_TLB_DM) == PAPI_OK;
+
             struct rusage usage; // For CPU and memory usage statistics
 
             // Store timings for each type of multiplication
@@ -97,6 +101,7 @@ void runExperimentalResults() {
                       << denseSparseTime << " | "
                       << sparseSparseTime << " | "
                       << cacheMisses[0] << " | "
+                      << (countTlbMisses ? std::to_string(cacheMisses[1]) : std::string("n/a")) << " | "
                       << peakMemory << " KB\n";
 
             // Cleanup PAPI resources for this iteration
@@ -0,0 +1,175 @@
+#include "huge_pages.hpp"
+#include <sys/mman.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+struct HugePageState {
+    HugePageState() : mode(static_cast<int>(HugePageMode::Transparent)), threshold(size_t(4) << 20) {
+        const char* env = std::getenv("MATRIX_HUGE_PAGES");
+        if (env != nullptr) {
+            if (std::strcmp(env, "off") == 0) {
+                mode = static_cast<int>(HugePageMode::Off);
+            } else if (std::strcmp(env, "explicit") == 0) {
+                mode = static_cast<int>(HugePageMode::Explicit);
+            }
+        }
+    }
+
+    std::atomic<int> mode;
+    std::atomic<size_t> threshold;
+
+    std::atomic<long long> explicitAllocations{0};
+    std::atomic<long long> transparentAllocations{0};
+    std::atomic<long long> fallbackAllocations{0};
+
+    // Mapped length of every live large buffer, so deallocation does not
+    // depend on the mode or threshold at that time
+    std::mutex mappingMutex;
+    std::unordered_map<void*, size_t> mappings;
+    size_t bytesMapped = 0;
+};
+
+HugePageState& state() {
+    static HugePageState* instance = new HugePageState(); // Leaked: buffers may be freed during exit
+    return *instance;
+}
+
+size_t roundToHugePages(size_t bytes) {
+    return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+}
+
+// Pages from the hugetlbfs pool, or nullptr when none are reserved
+void* mapExplicit(size_t length) {
+#ifdef MAP_HUGETLB
+    void* ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+#else
+    (void)length;
+    return nullptr;
+#endif
+}
+
+// Huge page aligned anonymous mapping, so the kernel can back it with 2 MB
+// pages; sets advised when madvise accepted the hint
+void* mapTransparent(size_t length, bool& advised) {
+    void* raw = mmap(nullptr, length + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+
+    // Trim the unaligned head and the tail of the over-sized mapping
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (start + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    if (aligned > start) {
+        munmap(raw, aligned - start);
+    }
+    size_t tail = (start + length + kHugePageSize) - (aligned + length);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + length), tail);
+    }
+
+    void* ptr = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+    advised = madvise(ptr, length, MADV_HUGEPAGE) == 0;
+#else
+    advised = false;
+#endif
+    return ptr;
+}
+
+} // namespace
+
+// Choose the backing of large buffers
+void setHugePageMode(HugePageMode mode, size_t thresholdBytes) {
+    state().mode = static_cast<int>(mode);
+    state().threshold = std::max(thresholdBytes, kHugePageSize);
+}
+
+// Get the current mode
+HugePageMode getHugePageMode() {
+    return static_cast<HugePageMode>(state().mode.load());
+}
+
+// Get the current threshold
+size_t getHugePageThreshold() {
+    return state().threshold;
+}
+
+// Snapshot of the counters
+HugePageStats getHugePageStats() {
+    HugePageState& s = state();
+    HugePageStats stats;
+    stats.explicitAllocations = s.explicitAllocations;
+    stats.transparentAllocations = s.transparentAllocations;
+    stats.fallbackAllocations = s.fallbackAllocations;
+    std::lock_guard<std::mutex> lock(s.mappingMutex);
+    stats.bytesMapped = s.bytesMapped;
+    return stats;
+}
+
+// Heap memory below the threshold, a huge page mapping above it
+void* allocateLargeBuffer(size_t bytes) {
+    HugePageState& s = state();
+    HugePageMode mode = static_cast<HugePageMode>(s.mode.load());
+    if (mode == HugePageMode::Off || bytes < s.threshold) {
+        return ::operator new(bytes);
+    }
+
+    size_t length = roundToHugePages(bytes);
+    void* ptr = nullptr;
+    if (mode == HugePageMode::Explicit) {
+        ptr = mapExplicit(length);
+        if (ptr != nullptr) {
+            ++s.explicitAllocations;
+        }
+    }
+    if (ptr == nullptr) {
+        bool advised = false;
+        ptr = mapTransparent(length, advised);
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        if (advised && mode == HugePageMode::Transparent) {
+            ++s.transparentAllocations;
+        } else {
+            ++s.fallbackAllocations; // Pool empty or THP unavailable; still 2 MB aligned
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(s.mappingMutex);
+    s.mappings[ptr] = length;
+    s.bytesMapped += length;
+    return ptr;
+}
+
+// Release a buffer from allocateLargeBuffer
+void deallocateLargeBuffer(void* ptr, size_t bytes) {
+    if (ptr == nullptr) {
+        return;
+    }
+    if (bytes >= kHugePageSize) { // Smaller buffers are never mapped
+        HugePageState& s = state();
+        size_t length = 0;
+        {
+            std::lock_guard<std::mutex> lock(s.mappingMutex);
+            auto found = s.mappings.find(ptr);
+            if (found != s.mappings.end()) {
+                length = found->second;
+                s.bytesMapped -= length;
+                s.mappings.erase(found);
+            }
+        }
+        if (length > 0) {
+            munmap(ptr, length);
+            return;
+        }
+    }
+    ::operator delete(ptr);
+}
@@ -0,0 +1,76 @@
+#ifndef HUGE_PAGES_HPP
+#define HUGE_PAGES_HPP
+
+#include <cstddef>
+#include <new>
+
+// How buffers at or above the huge page threshold are backed
+enum class HugePageMode {
+    Off,         // Ordinary heap memory
+    Transparent, // 2 MB aligned anonymous mapping with madvise(MADV_HUGEPAGE)
+    Explicit     // Pages from the hugetlbfs pool (MAP_HUGETLB), else Transparent
+};
+
+// Counters of the large allocations made so far
+struct HugePageStats {
+    long long explicitAllocations;    // Backed by the hugetlbfs pool
+    long long transparentAllocations; // Backed by an madvise'd mapping
+    long long fallbackAllocations;    // Huge pages requested but not available
+    size_t bytesMapped;               // Currently mapped by large allocations
+};
+
+// Size of a huge page (2 MB on x86-64)
+const size_t kHugePageSize = size_t(2) << 20;
+
+// Choose the backing of large buffers; buffers smaller than thresholdBytes
+// (at least one huge page) always come from the heap. Existing buffers keep
+// their backing. The defaults are Transparent above 4 MB, or the value of the
+// MATRIX_HUGE_PAGES environment variable (off, thp or explicit).
+void setHugePageMode(HugePageMode mode, size_t thresholdBytes = size_t(4) << 20);
+
+// Get the current mode and threshold
+HugePageMode getHugePageMode();
+size_t getHugePageThreshold();
+
+// Snapshot of the counters
+HugePageStats getHugePageStats();
+
+// Raw allocation used by HugePageAllocator (throws std::bad_alloc)
+void* allocateLargeBuffer(size_t bytes);
+void deallocateLargeBuffer(void* ptr, size_t bytes);
+
+// Standard allocator that applies the huge page policy, so large matrix
+// storage is backed by 2 MB pages and strided walks over it need far fewer
+// TLB entries
+template <typename T>
+class HugePageAllocator {
+public:
+    typedef T value_type;
+
+    HugePageAllocator() {}
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(allocateLargeBuffer(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) {
+        deallocateLargeBuffer(ptr, n * sizeof(T));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const HugePageAllocator<T>&, const HugePageAllocator<U>&) {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const HugePageAllocator<T>&, const HugePageAllocator<U>&) {
+    return false;
+}
+
+#endif // HUGE_PAGES_HPP
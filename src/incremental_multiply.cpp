@@ -0,0 +1,99 @@
+#include "incremental_multiply.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Rows of A handled per task when refreshing changed columns
+const int kRowBlock = 64;
+
+} // namespace
+
+// Bring C = A * B up to date after changes to A and B
+bool incrementalMultiply(const Matrix& A, const Matrix& B, Matrix& C,
+                         double fullRecomputeFraction,
+                         Matrix (*fullEngine)(const Matrix&, const Matrix&)) {
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+    if (C.getRows() != A.getRows() || C.getCols() != B.getCols()) {
+        throw std::invalid_argument("Result matrix dimensions do not match.");
+    }
+
+    // Without tracking an empty dirty set proves nothing
+    if (!A.isChangeTrackingEnabled() || !B.isChangeTrackingEnabled()) {
+        C = fullEngine(A, B);
+        return false;
+    }
+
+    int m = A.getRows();
+    int k = A.getCols();
+    int n = B.getCols();
+    const std::vector<int>& rows = A.getDirtyRows();
+    const std::vector<int>& cols = B.getDirtyCols();
+
+    // Cost model: changed rows cost a full row of C each, changed columns a
+    // column of C for every row that is not already being recomputed
+    double patchCells = static_cast<double>(rows.size()) * n +
+                        static_cast<double>(m - static_cast<int>(rows.size())) * cols.size();
+    double fullCells = static_cast<double>(m) * n;
+    if (fullCells > 0 && patchCells > fullRecomputeFraction * fullCells) {
+        C = fullEngine(A, B);
+        return false;
+    }
+
+    ThreadPool& pool = sharedThreadPool();
+
+    // Changed rows of A: C[i, :] = A[i, :] * B
+    pool.parallelFor(0, static_cast<int>(rows.size()), 4, [&](int lo, int hi) {
+        for (int r = lo; r < hi; ++r) {
+            double* cRow = C.rowData(rows[r]);
+            std::fill(cRow, cRow + n, 0.0);
+            simd_gemm_block(1, n, k, A.rowData(rows[r]), k, B.rowData(0), n, cRow, n);
+        }
+    });
+
+    // Changed columns of B: gather them, multiply A by the thin panel and
+    // scatter the result into the matching columns of C
+    int width = static_cast<int>(cols.size());
+    if (width == 0 || m == 0) {
+        return true;
+    }
+    std::vector<double> panel(static_cast<size_t>(k) * width);
+    for (int p = 0; p < k; ++p) {
+        const double* bRow = B.rowData(p);
+        for (int c = 0; c < width; ++c) {
+            panel[static_cast<size_t>(p) * width + c] = bRow[cols[c]];
+        }
+    }
+
+    std::vector<char> rowDone(m, 0);
+    for (int row : rows) {
+        rowDone[row] = 1; // Already recomputed against the new B
+    }
+
+    int blocks = (m + kRowBlock - 1) / kRowBlock;
+    pool.parallelFor(0, blocks, 1, [&](int lo, int hi) {
+        std::vector<double> update(static_cast<size_t>(kRowBlock) * width);
+        for (int block = lo; block < hi; ++block) {
+            int i0 = block * kRowBlock;
+            int height = std::min(kRowBlock, m - i0);
+            std::fill(update.begin(), update.end(), 0.0);
+            simd_gemm_block(height, width, k, A.rowData(i0), k, panel.data(), width, update.data(), width);
+            for (int i = 0; i < height; ++i) {
+                if (rowDone[i0 + i]) {
+                    continue;
+                }
+                double* cRow = C.rowData(i0 + i);
+                for (int c = 0; c < width; ++c) {
+                    cRow[cols[c]] = update[static_cast<size_t>(i) * width + c];
+                }
+            }
+        }
+    });
+
+    return true;
+}
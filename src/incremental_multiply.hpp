@@ -0,0 +1,22 @@
+#ifndef INCREMENTAL_MULTIPLY_HPP
+#define INCREMENTAL_MULTIPLY_HPP
+
+#include "cache_optimization.hpp"
+#include "matrix.hpp"
+
+// Bring C = A * B up to date after A and B changed, using the rows of A and
+// the columns of B recorded by change tracking (Matrix::enableChangeTracking).
+// Changed rows of A are recomputed as row times B, and changed columns of B
+// as A times the gathered columns. When the patch would cost more than
+// fullRecomputeFraction of a full product, C is recomputed with fullEngine
+// instead, and so it is when tracking is off on either operand, since nothing
+// then tells which parts changed. Returns true if C was patched, false if it
+// was recomputed. Writes made through rowData() are not tracked and must be
+// reported with markRowDirty() or markColDirty(), or C is left stale.
+// The dirty sets are left alone; call clearDirty() on the operands once every
+// product that depends on them has been brought up to date.
+bool incrementalMultiply(const Matrix& A, const Matrix& B, Matrix& C,
+                         double fullRecomputeFraction = 0.5,
+                         Matrix (*fullEngine)(const Matrix&, const Matrix&) = cache_optimized_multiply_dense_sparse);
+
+#endif // INCREMENTAL_MULTIPLY_HPP
@@ -0,0 +1,566 @@
+#include "job_server.hpp"
+#include "bsr_multiply.hpp"
+#include "cache_optimization.hpp"
+#include "combined_multiply.hpp"
+#include "matrix_io.hpp"
+#include "morton_matrix.hpp"
+#include "multithreading.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <poll.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// Engine selected by a request's engine hint (empty when the hint is unknown)
+MultiplyEngine engineFromHint(const std::string& hint) {
+    if (hint.empty() || hint == "auto" || hint == "tiled") {
+        return cache_optimized_multiply_dense_sparse; // Tile-map engine: SIMD on dense tiles, skips empty ones
+    }
+    if (hint == "dense") {
+        return cache_optimized_multiply_dense_dense;
+    }
+    if (hint == "simd") {
+        return simd_dense_dense_multiply;
+    }
+    if (hint == "threaded") {
+        return denseDenseMultiplyThreaded;
+    }
+    if (hint == "sparse") {
+        return sparseSparseMultiplyThreaded;
+    }
+    if (hint == "combined") {
+        return combinedDenseMultiply;
+    }
+    if (hint == "morton") {
+        return cacheObliviousMultiply;
+    }
+    if (hint == "bsr") {
+        return [](const Matrix& A, const Matrix& B) { return bsrDenseMultiply(BSRMatrix(A), B); };
+    }
+    return MultiplyEngine();
+}
+
+// Write a whole line to a socket
+void writeLine(int fd, const std::string& line) {
+    std::string data = line + "\n";
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return; // Client went away; nothing left to report to
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+// Lines waiting to be sent to one socket client. Job completions push here
+// from pool workers without blocking; the connection thread, woken through a
+// pipe, does the sending, so a client that stops reading only stalls itself.
+class Outbox {
+public:
+    Outbox() {
+        if (pipe(wake) != 0) {
+            throw std::runtime_error(std::string("Cannot create reply pipe: ") + std::strerror(errno));
+        }
+        fcntl(wake[0], F_SETFL, O_NONBLOCK);
+        fcntl(wake[1], F_SETFL, O_NONBLOCK);
+    }
+
+    ~Outbox() {
+        close(wake[0]);
+        close(wake[1]);
+    }
+
+    Outbox(const Outbox&) = delete;
+    Outbox& operator=(const Outbox&) = delete;
+
+    // Queue a line and wake the connection thread (never blocks)
+    void push(const std::string& line) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            lines.push_back(line);
+        }
+        char signal = 1;
+        ssize_t ignored = write(wake[1], &signal, 1); // A full pipe already means a pending wake-up
+        (void)ignored;
+    }
+
+    // Descriptor that becomes readable when lines are queued
+    int wakeFd() const {
+        return wake[0];
+    }
+
+    // Send every queued line to fd (connection thread only)
+    void flush(int fd) {
+        char drain[64];
+        while (read(wake[0], drain, sizeof(drain)) > 0) {
+        }
+        std::deque<std::string> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.swap(lines);
+        }
+        for (const std::string& line : pending) {
+            writeLine(fd, line);
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<std::string> lines;
+    int wake[2];
+};
+
+bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+// Default configuration
+JobServerConfig::JobServerConfig() : maxPendingJobs(16), pollIntervalMs(200), cacheBytes(0), cacheDiskBytes(0) {}
+
+// Constructor
+JobServer::JobServer(const JobServerConfig& config)
+    : config(config), stopping(false), nextJobId(1), startTime(std::chrono::steady_clock::now()),
+      stats(), pendingJobs(0) {
+    if (this->config.maxPendingJobs < 1) {
+        this->config.maxPendingJobs = 1;
+    }
+    if (this->config.cacheBytes > 0) {
+        cache.reset(new ProductCache(this->config.cacheBytes, this->config.cacheDir, this->config.cacheDiskBytes));
+    }
+}
+
+// Destructor
+JobServer::~JobServer() {
+    stop();
+}
+
+// Ask run() to return once pending jobs are finished
+void JobServer::stop() {
+    stopping = true;
+}
+
+// Block while too many jobs are pending (backpressure on the submitters)
+void JobServer::acquireSlot() {
+    std::unique_lock<std::mutex> lock(slotMutex);
+    slotFreed.wait(lock, [this] { return pendingJobs < config.maxPendingJobs; });
+    ++pendingJobs;
+}
+
+void JobServer::releaseSlot() {
+    {
+        std::lock_guard<std::mutex> lock(slotMutex);
+        --pendingJobs;
+    }
+    slotFreed.notify_all();
+}
+
+// Snapshot of the counters
+JobServerStats JobServer::getStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    JobServerStats snapshot = stats;
+    snapshot.uptimeSeconds = secondsSince(startTime);
+    return snapshot;
+}
+
+// Counters as a single human-readable line
+std::string JobServer::formatStats() const {
+    JobServerStats s = getStats();
+    long long finished = s.completed + s.failed;
+    std::ostringstream out;
+    out << "submitted=" << s.submitted << " completed=" << s.completed << " failed=" << s.failed
+        << " mean_latency_ms=" << (finished > 0 ? 1000.0 * s.totalLatencySeconds / finished : 0.0)
+        << " max_latency_ms=" << 1000.0 * s.maxLatencySeconds
+        << " jobs_per_s=" << (s.uptimeSeconds > 0 ? s.completed / s.uptimeSeconds : 0.0)
+        << " gflops=" << (s.totalComputeSeconds > 0 ? s.totalFlops / s.totalComputeSeconds * 1e-9 : 0.0)
+        << " uptime_s=" << s.uptimeSeconds;
+    if (cache) {
+        ProductCacheStats c = cache->getStats();
+        out << " cache_hits=" << c.hits << " cache_spill_hits=" << c.spillHits
+            << " cache_misses=" << c.misses << " cache_mb=" << c.bytesInMemory / (1024.0 * 1024.0)
+            << " cache_disk_mb=" << c.bytesOnDisk / (1024.0 * 1024.0);
+    }
+    return out.str();
+}
+
+// Parse a MULTIPLY request, load its operands and hand it to the scheduler.
+// reply receives exactly one DONE line, once the product is written or the
+// request has failed.
+void JobServer::submitJob(const std::string& request, const ReplyFunction& reply, long long id) {
+    std::istringstream in(request);
+    std::string command, aPath, bPath, outPath, hint;
+    in >> command >> aPath >> bPath >> outPath >> hint;
+    MultiplyEngine engine = engineFromHint(hint);
+    if (command != "MULTIPLY" || outPath.empty()) {
+        reply("DONE " + std::to_string(id) + " error expected MULTIPLY <A path> <B path> <output path> [engine]");
+        return;
+    }
+    if (!engine) {
+        reply("DONE " + std::to_string(id) + " error unknown engine '" + hint + "'");
+        return;
+    }
+
+    std::chrono::steady_clock::time_point accepted = std::chrono::steady_clock::now();
+    acquireSlot();
+    try {
+        Matrix A = loadMatrixBinary(aPath);
+        Matrix B = loadMatrixBinary(bPath);
+        double flops = 2.0 * A.getRows() * A.getCols() * B.getCols();
+
+        // The product is written from the worker and dropped right away, so
+        // finished jobs do not keep their result in memory
+        std::shared_ptr<double> computeSeconds = std::make_shared<double>(0.0);
+        AsyncOptions options;
+        ProductCache* productCache = cache.get();
+        std::string engineName = hint.empty() ? "auto" : hint;
+        options.engine = [engine, engineName, productCache, outPath, computeSeconds](const Matrix& a, const Matrix& b) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            Matrix product = productCache ? productCache->multiply(a, b, engineName, engine) : engine(a, b);
+            *computeSeconds = secondsSince(start);
+            saveMatrixBinary(product, outPath);
+            return Matrix(0, 0);
+        };
+        options.onComplete = [this, reply, id, accepted, flops, computeSeconds](const MultiplyHandle& handle) {
+            double latency = secondsSince(accepted);
+            std::ostringstream line;
+            bool ok = true;
+            try {
+                handle.get();
+                line << "DONE " << id << " ok latency_ms=" << 1000.0 * latency
+                     << " compute_ms=" << 1000.0 * *computeSeconds;
+            } catch (const std::exception& e) {
+                ok = false;
+                line << "DONE " << id << " error " << e.what();
+            }
+            {
+                std::lock_guard<std::mutex> lock(statsMutex);
+                if (ok) {
+                    ++stats.completed;
+                    stats.totalComputeSeconds += *computeSeconds;
+                    stats.totalFlops += flops;
+                } else {
+                    ++stats.failed;
+                }
+                stats.totalLatencySeconds += latency;
+                stats.maxLatencySeconds = std::max(stats.maxLatencySeconds, latency);
+            }
+            releaseSlot();
+            reply(line.str());
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            ++stats.submitted;
+        }
+        sharedMultiplyScheduler().submit(std::move(A), std::move(B), options);
+    } catch (const std::exception& e) {
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            ++stats.failed;
+            stats.totalLatencySeconds += secondsSince(accepted);
+        }
+        releaseSlot();
+        reply("DONE " + std::to_string(id) + " error " + e.what());
+    }
+}
+
+// Answer a request line that is not a MULTIPLY
+std::string JobServer::handleCommand(const std::string& line) {
+    std::istringstream in(line);
+    std::string command;
+    in >> command;
+
+    if (command == "STATS") {
+        return "STATS " + formatStats();
+    }
+    if (command == "SHUTDOWN") {
+        stop();
+        return "OK shutting down";
+    }
+    return "ERR unknown request '" + command + "'";
+}
+
+// Read request lines from one client until it disconnects or the server
+// stops. Only this thread writes to the socket; job replies reach it through
+// the outbox.
+void JobServer::serveConnection(int fd) {
+    std::shared_ptr<Outbox> outbox;
+    try {
+        outbox = std::make_shared<Outbox>();
+    } catch (const std::exception& e) {
+        writeLine(fd, std::string("ERR ") + e.what());
+        close(fd);
+        return;
+    }
+    std::shared_ptr<std::atomic<int>> outstanding = std::make_shared<std::atomic<int>>(0);
+    ReplyFunction reply = [outbox, outstanding](const std::string& line) {
+        outbox->push(line);
+        --*outstanding;
+    };
+
+    std::string buffer;
+    char chunk[4096];
+    bool open = true;
+    while (open && !stopping) {
+        pollfd pfds[2] = {{fd, POLLIN, 0}, {outbox->wakeFd(), POLLIN, 0}};
+        int ready = poll(pfds, 2, config.pollIntervalMs);
+        if (ready <= 0) {
+            continue;
+        }
+        if (pfds[1].revents & POLLIN) {
+            outbox->flush(fd);
+        }
+        if (!(pfds[0].revents & (POLLIN | POLLHUP | POLLERR))) {
+            continue;
+        }
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n <= 0) {
+            open = false;
+            continue;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+
+        size_t newline;
+        while ((newline = buffer.find('\n')) != std::string::npos) {
+            std::string line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            if (!line.empty() && line[line.size() - 1] == '\r') {
+                line.erase(line.size() - 1);
+            }
+            if (line.empty()) {
+                continue;
+            }
+            if (line.compare(0, 8, "MULTIPLY") == 0) {
+                // Acknowledge first so QUEUED always precedes the job's DONE line
+                long long id = nextJobId++;
+                ++*outstanding;
+                writeLine(fd, "QUEUED " + std::to_string(id));
+                submitJob(line, reply, id);
+            } else {
+                outbox->flush(fd); // Keep earlier DONE lines ahead of the answer
+                writeLine(fd, handleCommand(line));
+            }
+        }
+        outbox->flush(fd);
+    }
+
+    // Deliver the DONE lines of this client's jobs before closing
+    while (*outstanding > 0) {
+        pollfd pfd = {outbox->wakeFd(), POLLIN, 0};
+        poll(&pfd, 1, config.pollIntervalMs);
+        outbox->flush(fd);
+    }
+    outbox->flush(fd);
+    close(fd);
+}
+
+// Accept socket clients, one thread each
+void JobServer::serveSocket(int listenFd) {
+    while (!stopping) {
+        pollfd pfd = {listenFd, POLLIN, 0};
+        if (poll(&pfd, 1, config.pollIntervalMs) <= 0) {
+            continue;
+        }
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        for (size_t c = 0; c < connections.size();) {
+            if (*connections[c].second) {
+                connections[c].first.join();
+                connections.erase(connections.begin() + c);
+            } else {
+                ++c;
+            }
+        }
+        std::shared_ptr<std::atomic<bool>> finished = std::make_shared<std::atomic<bool>>(false);
+        connections.emplace_back(std::thread([this, fd, finished] {
+            serveConnection(fd);
+            *finished = true;
+        }), finished);
+    }
+}
+
+// Poll the spool directory for <name>.job files
+void JobServer::serveSpool() {
+    while (!stopping) {
+        std::vector<std::string> jobFiles;
+        DIR* dir = opendir(config.spoolDir.c_str());
+        if (dir != nullptr) {
+            while (dirent* entry = readdir(dir)) {
+                std::string name = entry->d_name;
+                if (endsWith(name, ".job")) {
+                    jobFiles.push_back(name);
+                }
+            }
+            closedir(dir);
+        }
+        std::sort(jobFiles.begin(), jobFiles.end());
+
+        for (size_t f = 0; f < jobFiles.size() && !stopping; ++f) {
+            std::string base = config.spoolDir + "/" + jobFiles[f].substr(0, jobFiles[f].size() - 4);
+            std::string taken = base + ".taken";
+            if (std::rename((base + ".job").c_str(), taken.c_str()) != 0) {
+                continue; // Claimed by someone else
+            }
+
+            std::string request;
+            std::ifstream in(taken);
+            std::getline(in, request);
+            in.close();
+
+            // The answer appears under its final name only once complete
+            std::string donePath = base + ".done";
+            ReplyFunction reply = [donePath, taken](const std::string& line) {
+                std::string partial = donePath + ".tmp";
+                {
+                    std::ofstream out(partial);
+                    out << line << "\n";
+                }
+                std::rename(partial.c_str(), donePath.c_str());
+                std::remove(taken.c_str());
+            };
+
+            submitJob(request, reply, nextJobId++);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(config.pollIntervalMs));
+    }
+}
+
+// Serve requests until stop() is called or a client sends SHUTDOWN
+void JobServer::run() {
+    if (config.socketPath.empty() && config.spoolDir.empty()) {
+        throw std::invalid_argument("Job server needs a socket path or a spool directory.");
+    }
+    stopping = false;
+    startTime = std::chrono::steady_clock::now();
+
+    int listenFd = -1;
+    if (!config.socketPath.empty()) {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (config.socketPath.size() >= sizeof(address.sun_path)) {
+            throw std::invalid_argument("Socket path is too long.");
+        }
+        std::strcpy(address.sun_path, config.socketPath.c_str());
+        unlink(config.socketPath.c_str());
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listenFd, 16) != 0) {
+            std::string reason = std::strerror(errno);
+            if (listenFd >= 0) {
+                close(listenFd);
+            }
+            throw std::runtime_error("Cannot listen on " + config.socketPath + ": " + reason);
+        }
+    }
+
+    std::thread socketThread;
+    std::thread spoolThread;
+    if (listenFd >= 0) {
+        socketThread = std::thread(&JobServer::serveSocket, this, listenFd);
+    }
+    if (!config.spoolDir.empty()) {
+        spoolThread = std::thread(&JobServer::serveSpool, this);
+    }
+
+    while (!stopping) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(config.pollIntervalMs));
+    }
+
+    if (socketThread.joinable()) {
+        socketThread.join();
+    }
+    if (spoolThread.joinable()) {
+        spoolThread.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        for (auto& connection : connections) {
+            connection.first.join();
+        }
+        connections.clear();
+    }
+
+    // Let accepted jobs finish so every client gets its answer
+    std::unique_lock<std::mutex> lock(slotMutex);
+    slotFreed.wait(lock, [this] { return pendingJobs == 0; });
+    lock.unlock();
+
+    if (listenFd >= 0) {
+        close(listenFd);
+        unlink(config.socketPath.c_str());
+    }
+}
+
+// Start a server from command-line options and block until it shuts down
+int runJobServer(int argc, char* argv[]) {
+    JobServerConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            config.socketPath = argv[++i];
+        } else if (arg == "--spool" && i + 1 < argc) {
+            config.spoolDir = argv[++i];
+        } else if (arg == "--max-pending" && i + 1 < argc) {
+            config.maxPendingJobs = std::atoi(argv[++i]);
+        } else if (arg == "--cache-mb" && i + 1 < argc) {
+            config.cacheBytes = static_cast<size_t>(std::atof(argv[++i]) * 1024 * 1024);
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            config.cacheDir = argv[++i];
+        } else if (arg == "--cache-disk-mb" && i + 1 < argc) {
+            config.cacheDiskBytes = static_cast<size_t>(std::atof(argv[++i]) * 1024 * 1024);
+        }
+    }
+    if (config.socketPath.empty() && config.spoolDir.empty()) {
+        std::cerr << "Usage: " << argv[0]
+                  << " --server [--socket PATH] [--spool DIR] [--max-pending N]"
+                  << " [--cache-mb N] [--cache-dir DIR] [--cache-disk-mb N]" << std::endl;
+        return 1;
+    }
+    if (!config.cacheDir.empty() && config.cacheBytes == 0) {
+        std::cerr << "Error: --cache-dir needs --cache-mb (the cache is off without a memory budget)" << std::endl;
+        return 1;
+    }
+
+    try {
+        JobServer server(config);
+        std::cout << "Job server running (socket: "
+                  << (config.socketPath.empty() ? "none" : config.socketPath)
+                  << ", spool: " << (config.spoolDir.empty() ? "none" : config.spoolDir) << ")" << std::endl;
+        server.run();
+        std::cout << "Job server stopped: " << server.formatStats() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
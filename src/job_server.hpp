@@ -0,0 +1,108 @@
+#ifndef JOB_SERVER_HPP
+#define JOB_SERVER_HPP
+
+#include "async_multiply.hpp"
+#include "product_cache.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Configuration of the batch job server (leave a path empty to disable that input)
+struct JobServerConfig {
+    JobServerConfig();
+
+    std::string socketPath; // Unix domain socket accepting request lines
+    std::string spoolDir;   // Directory polled for *.job files
+    int maxPendingJobs;     // Jobs loading, queued or running before submitters block
+    int pollIntervalMs;     // Spool scan and shutdown check interval
+    size_t cacheBytes;      // Product cache budget (0 disables the cache)
+    std::string cacheDir;   // Spill directory of the product cache (optional)
+    size_t cacheDiskBytes;  // Spill directory budget (0 means four times cacheBytes)
+};
+
+// Counters reported by the STATS request
+struct JobServerStats {
+    long long submitted;
+    long long completed;
+    long long failed;
+    double totalLatencySeconds; // From request accepted to product written
+    double maxLatencySeconds;
+    double totalComputeSeconds; // Time spent inside the engines
+    double totalFlops;          // 2 * m * n * k summed over completed jobs
+    double uptimeSeconds;
+};
+
+// Long-running server that accepts multiply jobs and runs them on the shared
+// scheduler, so thread pools and per-thread buffers stay warm across jobs.
+//
+// A request is one line: MULTIPLY <A path> <B path> <output path> [engine]
+// where operands use the binary matrix format and engine is one of auto,
+// dense, tiled, simd, threaded, combined, sparse, bsr or morton. Socket
+// clients get "QUEUED <id>" right away and "DONE <id> ok ..." or
+// "DONE <id> error ..." when the job finishes; they may also send STATS or
+// SHUTDOWN. A spool file <name>.job holding a request line is answered in
+// <name>.done, which is written under a temporary name and renamed so that it
+// only ever appears complete.
+class JobServer {
+public:
+    explicit JobServer(const JobServerConfig& config);
+    ~JobServer();
+
+    JobServer(const JobServer&) = delete;
+    JobServer& operator=(const JobServer&) = delete;
+
+    // Serve requests until stop() is called or a client sends SHUTDOWN
+    void run();
+
+    // Ask run() to return once pending jobs are finished
+    void stop();
+
+    // Snapshot of the counters
+    JobServerStats getStats() const;
+
+    // Counters as a single human-readable line
+    std::string formatStats() const;
+
+private:
+    typedef std::function<void(const std::string&)> ReplyFunction;
+
+    void serveSocket(int listenFd);
+    void serveConnection(int fd);
+    void serveSpool();
+    std::string handleCommand(const std::string& line);
+    void submitJob(const std::string& request, const ReplyFunction& reply, long long id);
+
+    void acquireSlot();
+    void releaseSlot();
+
+    JobServerConfig config;
+    std::unique_ptr<ProductCache> cache; // Shared by all jobs when enabled
+    std::atomic<bool> stopping;
+    std::atomic<long long> nextJobId;
+    std::chrono::steady_clock::time_point startTime;
+
+    mutable std::mutex statsMutex;
+    JobServerStats stats;
+
+    std::mutex slotMutex;
+    std::condition_variable slotFreed;
+    int pendingJobs;
+
+    // Client threads with a flag set when they finish, so they can be joined early
+    std::mutex connectionMutex;
+    std::vector<std::pair<std::thread, std::shared_ptr<std::atomic<bool>>>> connections;
+};
+
+// Start a server from command-line options (--socket PATH, --spool DIR,
+// --max-pending N, --cache-mb N, --cache-dir DIR, --cache-disk-mb N) and
+// block until it shuts down; returns an exit code
+int runJobServer(int argc, char* argv[]);
+
+#endif // JOB_SERVER_HPP
@@ -4,15 +4,18 @@
 #include <papi.h>
 #include "performance_test.cpp"
 #include "multithreading.hpp"
-#include "simd.cpp"
 #include "simd.hpp"
 #include "cache_optimization.hpp"
-#include "cache_optimization.cpp"
+#include "combined_multiply.hpp"
 #include "performance_multithreading.cpp"
 #include "performance_simd.cpp"
 #include "performance_cache.cpp"
+#include "performance_combined.cpp"
 #include "experimental_results.cpp"
 #include "experimental_multithreading.cpp"
+#include "job_server.hpp"
+#include "summa.hpp"
+#include "sparse_benchmark.hpp"
 
 // Running tests
 void optimizationTest() {
@@ -42,7 +45,7 @@ void optimizationTest() {
                           << "Sparsity B: " << sparsityB << std::endl;
 
                 // Measure performance for each optimization
-                char optimizations[3] = {'m', 's', 'c'}; // multithreading, SIMD, cache optimization
+                char optimizations[4] = {'m', 's', 'c', 'a'}; // multithreading, SIMD, cache optimization, all combined
 
                 for (char opt : optimizations) {
                     auto start = std::chrono::high_resolution_clock::now();
@@ -54,6 +57,8 @@ void optimizationTest() {
                         Matrix result = simd_dense_dense_multiply(A, B);
                     } else if (opt == 'c') {
                         Matrix result = cache_optimized_multiply_dense_dense(A, B);
+                    } else if (opt == 'a') {
+                        Matrix result = combinedDenseMultiply(A, B);
                     }
 
                     auto end = std::chrono::high_resolution_clock::now();
@@ -67,7 +72,22 @@ void optimizationTest() {
 }
 
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Long-running batch mode: serve multiply jobs instead of prompting
+    if (argc > 1 && std::string(argv[1]) == "--server") {
+        return runJobServer(argc, argv);
+    }
+
+    // Distributed multiply over a grid of local processes
+    if (argc > 1 && std::string(argv[1]) == "--summa") {
+        return runSummaBenchmark(argc, argv);
+    }
+
+    // Every sparse engine over the generated workload suite
+    if (argc > 1 && std::string(argv[1]) == "--sparse-bench") {
+        return runSparseBenchmark(argc, argv);
+    }
+
     int rowsA, colsA, rowsB, colsB;
     double sparsityA, sparsityB;
 
@@ -119,7 +139,7 @@ int main() {
 
     // Ask the user if they want to use multithreading, SIMD, or cache optimization for optimization
     char useOptimization;
-    std::cout << "Do you want to use optimization? (m for multithreading, s for SIMD, c for cache optimization, n for none): ";
+    std::cout << "Do you want to use optimization? (m for multithreading, s for SIMD, c for cache optimization, a for all combined, n for none): ";
     std::cin >> useOptimization;
 
     // Measure performance
@@ -134,6 +154,8 @@ int main() {
             result = simd_dense_dense_multiply(A, B);
         } else if (useOptimization == 'c' || useOptimization == 'C') {
             result = cache_optimized_multiply_dense_dense(A, B);
+        } else if (useOptimization == 'a' || useOptimization == 'A') {
+            result = combinedDenseMultiply(A, B);
         } else {
             result = A.multiply(B);
         }
@@ -146,6 +168,8 @@ int main() {
             result = simd_dense_sparse_multiply(A, B);
         } else if (useOptimization == 'c' || useOptimization == 'C') {
             result = cache_optimized_multiply_dense_sparse(A, B);
+        } else if (useOptimization == 'a' || useOptimization == 'A') {
+            result = combinedDenseMultiply(A, B);
         } else {
             result = A.multiplySparse(B);
         }
@@ -158,6 +182,8 @@ int main() {
             result = simd_sparse_sparse_multiply(A, B);
         } else if (useOptimization == 'c' || useOptimization == 'C') {
             result = cache_optimized_multiply_sparse_sparse(A, B);
+        } else if (useOptimization == 'a' || useOptimization == 'A') {
+            result = combinedDenseMultiply(A, B);
         } else {
             result = A.multiplySparseSparse(B);
         }
@@ -188,6 +214,9 @@ int main() {
         } else if (useOptimization == 'c' || useOptimization == 'C') {
             std::cout << "Running cache optimization performance test...\n";
             performCacheOptimizedTest(rowsA, colsA, sparsityA);
+        } else if (useOptimization == 'a' || useOptimization == 'A') {
+            std::cout << "Running combined engine performance test...\n";
+            performTestCombined(rowsA, colsA, sparsityA);
         } else {
             std::cout << "Running default performance test...\n";
             performTest(rowsA, colsA, sparsityA);
@@ -1,4 +1,5 @@
 #include "matrix.hpp"
+#include <stdexcept>
 
 
 // Get number of rows
@@ -16,18 +17,126 @@ double Matrix::get(int row, int col) const {
     if (row < 0 || row >= rows || col < 0 || col >= cols) {
         throw std::out_of_range("Matrix index out of range");
     }
-    return data[row][col];
+    return data[index(row, col)];
 }
 
 
 // Set individual elements
 void Matrix::set(int row, int col, double value) {
-    data[row][col] = value;
+    double& element = data[index(row, col)];
+    if (!dirtyRowFlags.empty() && element != value) {
+        markRowDirty(row);
+        markColDirty(col);
+    }
+    element = value;
+}
+
+// View of the whole matrix
+MatrixView Matrix::view() const {
+    return MatrixView(*this);
+}
+
+// View of a block
+MatrixView Matrix::view(int r0, int c0, int r, int c) const {
+    return MatrixView(*this).view(r0, c0, r, c);
+}
+
+// Transposed view
+MatrixView Matrix::transpose() const {
+    return MatrixView(*this).transpose();
+}
+
+// Resize to r x c with every element zero
+void Matrix::reset(int r, int c) {
+    rows = r;
+    cols = c;
+    data.assign(static_cast<size_t>(r) * c, 0.0); // Reuses the capacity when it suffices
+    if (!dirtyRowFlags.empty()) {
+        dirtyRowFlags.assign(rows + 1, 0);
+        dirtyColFlags.assign(cols + 1, 0);
+        dirtyRows.clear();
+        dirtyCols.clear();
+    }
+}
+
+// Start recording which rows and columns change
+void Matrix::enableChangeTracking() {
+    if (dirtyRowFlags.empty()) {
+        dirtyRowFlags.assign(rows + 1, 0); // One spare slot keeps the vector non-empty for 0-row matrices
+        dirtyColFlags.assign(cols + 1, 0);
+    }
+}
+
+// Replace a whole row in one call
+void Matrix::setRow(int row, const std::vector<double>& values) {
+    if (row < 0 || row >= rows || static_cast<int>(values.size()) != cols) {
+        throw std::out_of_range("Row index or length out of range");
+    }
+    double* target = rowData(row);
+    for (int col = 0; col < cols; ++col) {
+        if (!dirtyRowFlags.empty() && target[col] != values[col]) {
+            markRowDirty(row);
+            markColDirty(col);
+        }
+        target[col] = values[col];
+    }
+}
+
+// True once change tracking is on
+bool Matrix::isChangeTrackingEnabled() const {
+    return !dirtyRowFlags.empty();
+}
+
+// Record a changed row (ignored while tracking is off)
+void Matrix::markRowDirty(int row) {
+    if (!dirtyRowFlags.empty() && !dirtyRowFlags[row]) {
+        dirtyRowFlags[row] = 1;
+        dirtyRows.push_back(row);
+    }
+}
+
+// Record a changed column (ignored while tracking is off)
+void Matrix::markColDirty(int col) {
+    if (!dirtyColFlags.empty() && !dirtyColFlags[col]) {
+        dirtyColFlags[col] = 1;
+        dirtyCols.push_back(col);
+    }
+}
+
+// Get the rows changed since the last clearDirty()
+const std::vector<int>& Matrix::getDirtyRows() const {
+    return dirtyRows;
+}
+
+// Get the columns changed since the last clearDirty()
+const std::vector<int>& Matrix::getDirtyCols() const {
+    return dirtyCols;
+}
+
+// Forget the recorded changes
+void Matrix::clearDirty() {
+    for (int row : dirtyRows) {
+        dirtyRowFlags[row] = 0;
+    }
+    for (int col : dirtyCols) {
+        dirtyColFlags[col] = 0;
+    }
+    dirtyRows.clear();
+    dirtyCols.clear();
+}
+
+// Direct access to the contiguous elements of one row
+const double* Matrix::rowData(int row) const {
+    return data.data() + index(row, 0);
+}
+
+double* Matrix::rowData(int row) {
+    return data.data() + index(row, 0);
 }
 
 // Constructor
 Matrix::Matrix(int rows, int cols) : rows(rows), cols(cols) {
-    data.resize(rows, std::vector<double>(cols)); // Ensure this is correct
+    data.resize(static_cast<size_t>(rows) * cols); // One contiguous block, zero-initialized
 }
 
 
@@ -38,19 +147,26 @@ void Matrix::fillRandom(double sparsity) {
         for (int j = 0; j < cols; ++j) {
             // Fill with random values based on sparsity
             if (static_cast<double>(std::rand()) / RAND_MAX >= sparsity) {
-                data[i][j] = static_cast<double>(std::rand()) / RAND_MAX * 10; // Random value between 0 and 10
+                data[index(i, j)] = static_cast<double>(std::rand()) / RAND_MAX * 10; // Random value between 0 and 10
             } else {
-                data[i][j] = 0.0; // Sparse element
+                data[index(i, j)] = 0.0; // Sparse element
             }
         }
     }
+    // Every element may have changed
+    for (int i = 0; i < rows; ++i) {
+        markRowDirty(i);
+    }
+    for (int j = 0; j < cols; ++j) {
+        markColDirty(j);
+    }
 }
 
 // Display the matrix
 void Matrix::display() const {
-    for (const auto& row : data) {
-        for (double val : row) {
-            std::cout << val << " ";
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            std::cout << data[index(i, j)] << " ";
         }
         std::cout << std::endl;
     }
@@ -66,7 +182,7 @@ Matrix Matrix::multiply(const Matrix& other) const {
     for (int i = 0; i < rows; ++i) {
         for (int j = 0; j < other.cols; ++j) {
             for (int k = 0; k < cols; ++k) {
-                result.data[i][j] += data[i][k] * other.data[k][j];
+                result.data[result.index(i, j)] += data[index(i, k)] * other.data[other.index(k, j)];
             }
         }
     }
@@ -84,8 +200,8 @@ Matrix Matrix::multiplySparse(const Matrix& sparseMatrix) const {
     for (int i = 0; i < rows; ++i) {
         for (int j = 0; j < sparseMatrix.cols; ++j) {
             for (int k = 0; k < cols; ++k) {
-                if (sparseMatrix.data[k][j] != 0) { // Only multiply if the element is non-zero
-                    result.data[i][j] += data[i][k] * sparseMatrix.data[k][j];
+                if (sparseMatrix.data[sparseMatrix.index(k, j)] != 0) { // Only multiply if the element is non-zero
+                    result.data[result.index(i, j)] += data[index(i, k)] * sparseMatrix.data[sparseMatrix.index(k, j)];
                 }
             }
         }
@@ -106,11 +222,11 @@ Matrix Matrix::multiplySparseSparse(const Matrix& other) const {
             double sum = 0.0;
             for (int k = 0; k < cols; ++k) {
                 // Only multiply non-zero elements
-                if (data[i][k] != 0 && other.data[k][j] != 0) {
-                    sum += data[i][k] * other.data[k][j];
+                if (data[index(i, k)] != 0 && other.data[other.index(k, j)] != 0) {
+                    sum += data[index(i, k)] * other.data[other.index(k, j)];
                 }
             }
-            result.data[i][j] = sum;
+            result.data[result.index(i, j)] = sum;
         }
     }
     return result;
@@ -120,7 +236,7 @@ bool Matrix::isNonZero(int row, int col) const {
     if (row < 0 || row >= rows || col < 0 || col >= cols) {
         throw std::out_of_range("Matrix index out of range");
     }
-    return data[row][col] != 0.0;
+    return data[index(row, col)] != 0.0;
 }
 
 void Matrix::setResult(const Matrix& result) {
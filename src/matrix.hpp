@@ -5,6 +5,8 @@
 #include <iostream>
 #include <cstdlib> // For std::rand and std::srand
 #include <ctime>   // For std::time
+#include "huge_pages.hpp"
+#include "matrix_view.hpp"
 
 class Matrix {
 public:
@@ -43,12 +45,60 @@ public:
     // Set individual elements (optional, but useful)
     void set(int row, int col, double value);
 
+    // Direct access to the elements of one row (for vectorized kernels).
+    // Rows are stored back to back, so rowData(i + 1) == rowData(i) + getCols().
+    const double* rowData(int row) const;
+    double* rowData(int row);
 
+    // Non-owning view of the whole matrix or of an r x c block at (r0, c0), in O(1)
+    MatrixView view() const;
+    MatrixView view(int r0, int c0, int r, int c) const;
+
+    // Transposed view, in O(1) (use toMatrix() on it for an owning copy)
+    MatrixView transpose() const;
+
+    // Resize to r x c with every element zero, keeping the allocated storage
+    // when it is large enough (for reusing temporaries)
+    void reset(int r, int c);
+
+    // Start recording which rows and columns are changed by set() and setRow()
+    // (an element that changes marks both its row and its column; fillRandom()
+    // marks everything). Writes through rowData() are not seen; report them
+    // with markRowDirty() and markColDirty().
+    void enableChangeTracking();
+
+    // True once enableChangeTracking() has been called
+    bool isChangeTrackingEnabled() const;
+
+    // Replace a whole row in one call (batch update)
+    void setRow(int row, const std::vector<double>& values);
+
+    // Record a change made outside set() and setRow()
+    void markRowDirty(int row);
+    void markColDirty(int col);
+
+    // Rows and columns changed since tracking started or clearDirty() was called
+    const std::vector<int>& getDirtyRows() const;
+    const std::vector<int>& getDirtyCols() const;
+
+    // Forget the recorded changes (tracking stays on)
+    void clearDirty();
 
 private:
+    // Offset of an element in data
+    size_t index(int row, int col) const {
+        return static_cast<size_t>(row) * cols + col;
+    }
+
     int rows;
     int cols;
-    std::vector<std::vector<double>> data; // Matrix data
+    std::vector<double, HugePageAllocator<double>> data; // Matrix data, row-major (huge pages when large)
+
+    // Change tracking (empty flag vectors while tracking is off)
+    std::vector<char> dirtyRowFlags;
+    std::vector<char> dirtyColFlags;
+    std::vector<int> dirtyRows;
+    std::vector<int> dirtyCols;
 };
 
 #endif // MATRIX_HPP
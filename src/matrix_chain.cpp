@@ -0,0 +1,442 @@
+#include "matrix_chain.hpp"
+#include "cache_optimization.hpp"
+#include "csr_matrix.hpp"
+#include "simd.hpp"
+#include "spgemm.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Relative costs of the model, in units of one flop of the dense SIMD kernel
+const double kDenseFlopCost = 1.0;
+const double kScalarFlopCost = 4.0;   // Sparse tile kernel of the tiled engine
+const double kSparseFlopCost = 16.0;  // Hash or dense accumulator update in SpGEMM
+const double kElementCost = 0.5;      // Reading or writing one dense element
+const double kSparseEntryCost = 4.0;  // Building or reading one CSR entry
+
+// Tile edge of the tiled engine and its dense/sparse tile threshold
+const int kTileSize = 64;
+const double kSparseTileDensity = 0.25;
+
+// Rows of the result per task in the dense engine
+const int kRowBlock = 64;
+
+// Estimated non-zero structure of a (possibly intermediate) matrix
+struct Sketch {
+    int rows;
+    int cols;
+    std::vector<double> rowCounts; // Non-zero elements per row
+    std::vector<double> colCounts; // Non-zero elements per column
+    double nonZeros;
+    bool csr;                      // Stored as CSR (a sparse factor or a SpGEMM result)
+
+    double density() const {
+        double cells = static_cast<double>(rows) * cols;
+        return cells > 0 ? nonZeros / cells : 0.0;
+    }
+};
+
+// Exact sketch of a factor (for a CSR factor, in O(non-zeros))
+Sketch sketchOf(const ChainOperand& factor) {
+    Sketch s;
+    s.rows = factor.getRows();
+    s.cols = factor.getCols();
+    s.rowCounts.assign(s.rows, 0.0);
+    s.colCounts.assign(s.cols, 0.0);
+    s.nonZeros = 0.0;
+    s.csr = factor.isSparse();
+    if (s.csr) {
+        const CSRMatrix& M = factor.getSparse();
+        for (int i = 0; i < s.rows; ++i) {
+            s.rowCounts[i] = M.rowPtr[i + 1] - M.rowPtr[i];
+            for (int p = M.rowPtr[i]; p < M.rowPtr[i + 1]; ++p) {
+                s.colCounts[M.colIndices[p]] += 1.0;
+            }
+        }
+        s.nonZeros = M.getNonZeros();
+        return s;
+    }
+    const Matrix& M = factor.getDense();
+    for (int i = 0; i < s.rows; ++i) {
+        const double* row = M.rowData(i);
+        for (int j = 0; j < s.cols; ++j) {
+            if (row[j] != 0.0) {
+                s.rowCounts[i] += 1.0;
+                s.colCounts[j] += 1.0;
+            }
+        }
+        s.nonZeros += s.rowCounts[i];
+    }
+    return s;
+}
+
+// Multiply-adds of L * R when every product of matching non-zeros is formed
+double sparseFlops(const Sketch& L, const Sketch& R) {
+    double flops = 0.0;
+    for (int p = 0; p < L.cols; ++p) {
+        flops += L.colCounts[p] * R.rowCounts[p];
+    }
+    return flops;
+}
+
+// Fraction of cells hit at least once when hits land uniformly at random
+double coverage(double hits, double cells) {
+    return cells > 0 ? 1.0 - std::exp(-hits / cells) : 0.0;
+}
+
+// Scale counts so that they add up to total
+void rescale(std::vector<double>& counts, double total) {
+    double sum = 0.0;
+    for (double c : counts) {
+        sum += c;
+    }
+    if (sum > 0) {
+        for (double& c : counts) {
+            c *= total / sum;
+        }
+    }
+}
+
+// Estimated sketch of L * R: each non-zero of a row of L hits an average row
+// of R, and products fall uniformly over the columns of the result
+Sketch sketchProduct(const Sketch& L, const Sketch& R, double flops, bool csr) {
+    Sketch s;
+    s.csr = csr;
+    s.rows = L.rows;
+    s.cols = R.cols;
+    int inner = L.cols;
+    double perRowR = inner > 0 ? R.nonZeros / inner : 0.0;
+    double perColL = inner > 0 ? L.nonZeros / inner : 0.0;
+
+    s.rowCounts.resize(s.rows);
+    for (int i = 0; i < s.rows; ++i) {
+        s.rowCounts[i] = s.cols * coverage(L.rowCounts[i] * perRowR, s.cols);
+    }
+    s.colCounts.resize(s.cols);
+    for (int j = 0; j < s.cols; ++j) {
+        s.colCounts[j] = s.rows * coverage(R.colCounts[j] * perColL, s.rows);
+    }
+
+    double cells = static_cast<double>(s.rows) * s.cols;
+    s.nonZeros = cells * coverage(flops, cells);
+    rescale(s.rowCounts, s.nonZeros);
+    rescale(s.colCounts, s.nonZeros);
+    return s;
+}
+
+// Probability that a kTileSize x kTileSize tile holds a non-zero element
+double tileOccupancy(double density) {
+    return 1.0 - std::pow(1.0 - std::min(1.0, density), static_cast<double>(kTileSize) * kTileSize);
+}
+
+// Cost of densifying an operand for a dense engine (zero when already dense)
+double toDenseCost(const Sketch& S) {
+    return S.csr ? static_cast<double>(S.rows) * S.cols * kElementCost + S.nonZeros * kSparseEntryCost : 0.0;
+}
+
+// Cost of scanning a dense operand to build its CSR form (zero when already CSR)
+double toSparseCost(const Sketch& S) {
+    return S.csr ? 0.0 : static_cast<double>(S.rows) * S.cols * kElementCost;
+}
+
+// Cheapest engine for L * R and its modelled cost; the final product of the
+// chain has to end up dense
+std::pair<ChainEngine, double> cheapestEngine(const Sketch& L, const Sketch& R, double flops,
+                                              double outNonZeros, bool finalStep) {
+    double m = L.rows;
+    double k = L.cols;
+    double n = R.cols;
+    double elements = m * k + k * n + m * n;
+    double densify = toDenseCost(L) + toDenseCost(R);
+
+    double dense = 2.0 * m * k * n * kDenseFlopCost + elements * kElementCost + densify;
+
+    // Tiled engine: tile pairs with an empty side are skipped; the others
+    // run the SIMD kernel or, when sparse, the scalar kernel over A's non-zeros
+    double occupiedR = tileOccupancy(R.density());
+    double tileWork = (L.density() >= kSparseTileDensity && R.density() >= kSparseTileDensity)
+                          ? 2.0 * m * k * n * kDenseFlopCost * tileOccupancy(L.density()) * occupiedR
+                          : 2.0 * L.nonZeros * n * kScalarFlopCost * occupiedR;
+    double tiled = tileWork + 2.0 * elements * kElementCost + densify; // Tile maps read both operands again
+
+    // SpGEMM: dense operands are converted to CSR; the result stays CSR
+    // unless it is the final product
+    double sparse = flops * kSparseFlopCost + toSparseCost(L) + toSparseCost(R) +
+                    (L.nonZeros + R.nonZeros + outNonZeros) * kSparseEntryCost +
+                    (finalStep ? m * n * kElementCost : 0.0);
+
+    std::pair<ChainEngine, double> best(ChainEngine::Dense, dense);
+    if (tiled < best.second) {
+        best = std::make_pair(ChainEngine::Tiled, tiled);
+    }
+    if (sparse < best.second) {
+        best = std::make_pair(ChainEngine::Sparse, sparse);
+    }
+    return best;
+}
+
+const char* engineName(ChainEngine engine) {
+    switch (engine) {
+    case ChainEngine::Dense:
+        return "dense";
+    case ChainEngine::Tiled:
+        return "tiled";
+    default:
+        return "sparse";
+    }
+}
+
+// Dense form of an operand: the operand itself, or a copy made in scratch
+const Matrix& denseOf(const ChainOperand& operand, Matrix& scratch) {
+    if (!operand.isSparse()) {
+        return operand.getDense();
+    }
+    scratch = operand.toDense();
+    return scratch;
+}
+
+// CSR form of an operand: the operand itself, or a copy made in scratch
+const CSRMatrix& sparseOf(const ChainOperand& operand, CSRMatrix& scratch) {
+    if (operand.isSparse()) {
+        return operand.getSparse();
+    }
+    scratch = CSRMatrix(operand.getDense());
+    return scratch;
+}
+
+// Dense product written into a recycled buffer
+void denseInto(const Matrix& L, const Matrix& R, Matrix& out) {
+    int m = L.getRows();
+    int k = L.getCols();
+    int n = R.getCols();
+    out.reset(m, n);
+    if (m == 0 || n == 0 || k == 0) {
+        return;
+    }
+    int blocks = (m + kRowBlock - 1) / kRowBlock;
+    sharedThreadPool().parallelFor(0, blocks, 1, [&](int lo, int hi) {
+        for (int block = lo; block < hi; ++block) {
+            int i0 = block * kRowBlock;
+            simd_gemm_block(std::min(kRowBlock, m - i0), n, k, L.rowData(i0), k,
+                            R.rowData(0), n, out.rowData(i0), n);
+        }
+    });
+}
+
+// Append the steps of interval [i, j] in execution order; returns its operand index
+int emitSteps(const std::vector<std::vector<int>>& split, const std::vector<std::vector<ChainEngine>>& engine,
+              const std::vector<std::vector<double>>& stepCost, const std::vector<std::vector<double>>& density,
+              int i, int j, ChainPlan& plan) {
+    if (i == j) {
+        return i;
+    }
+    int s = split[i][j];
+    ChainStep step;
+    step.left = emitSteps(split, engine, stepCost, density, i, s, plan);
+    step.right = emitSteps(split, engine, stepCost, density, s + 1, j, plan);
+    step.engine = engine[i][j];
+    step.estimatedCost = stepCost[i][j];
+    step.estimatedDensity = density[i][j];
+    plan.steps.push_back(step);
+    return plan.factorCount + static_cast<int>(plan.steps.size()) - 1;
+}
+
+void describe(const ChainPlan& plan, int operand, std::ostringstream& out) {
+    if (operand < plan.factorCount) {
+        out << "M" << operand;
+        return;
+    }
+    const ChainStep& step = plan.steps[operand - plan.factorCount];
+    out << "(";
+    describe(plan, step.left, out);
+    out << " ";
+    describe(plan, step.right, out);
+    out << ")[" << engineName(step.engine) << "]";
+}
+
+} // namespace
+
+// Constructors
+ChainOperand::ChainOperand(const Matrix& dense) : sparse(false), dense(dense), csr(0, 0) {}
+ChainOperand::ChainOperand(Matrix&& dense) : sparse(false), dense(std::move(dense)), csr(0, 0) {}
+ChainOperand::ChainOperand(const CSRMatrix& sparse) : sparse(true), dense(0, 0), csr(sparse) {}
+ChainOperand::ChainOperand(CSRMatrix&& sparse) : sparse(true), dense(0, 0), csr(std::move(sparse)) {}
+
+// True for a CSR operand
+bool ChainOperand::isSparse() const {
+    return sparse;
+}
+
+// Get number of rows
+int ChainOperand::getRows() const {
+    return sparse ? csr.getRows() : dense.getRows();
+}
+
+// Get number of columns
+int ChainOperand::getCols() const {
+    return sparse ? csr.getCols() : dense.getCols();
+}
+
+// The stored dense matrix
+const Matrix& ChainOperand::getDense() const {
+    return dense;
+}
+
+// The stored CSR matrix
+const CSRMatrix& ChainOperand::getSparse() const {
+    return csr;
+}
+
+// Dense copy
+Matrix ChainOperand::toDense() const {
+    return sparse ? csr.toDense() : dense;
+}
+
+// Move the dense matrix out
+Matrix ChainOperand::takeDense() {
+    Matrix taken(std::move(dense));
+    dense = Matrix(0, 0);
+    return taken;
+}
+
+// Parenthesization with engines
+std::string ChainPlan::toString() const {
+    std::ostringstream out;
+    describe(*this, steps.empty() ? 0 : factorCount + static_cast<int>(steps.size()) - 1, out);
+    return out.str();
+}
+
+// Dynamic program over all parenthesizations (O(n^3) split points)
+ChainPlan planMatrixChain(const std::vector<ChainOperand>& factors) {
+    int n = static_cast<int>(factors.size());
+    if (n == 0) {
+        throw std::invalid_argument("Matrix chain is empty.");
+    }
+    for (int i = 0; i + 1 < n; ++i) {
+        if (factors[i].getCols() != factors[i + 1].getRows()) {
+            throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+        }
+    }
+
+    std::vector<std::vector<double>> cost(n, std::vector<double>(n, 0.0));
+    std::vector<std::vector<double>> stepCost(n, std::vector<double>(n, 0.0));
+    std::vector<std::vector<double>> density(n, std::vector<double>(n, 0.0));
+    std::vector<std::vector<int>> split(n, std::vector<int>(n, -1));
+    std::vector<std::vector<ChainEngine>> engine(n, std::vector<ChainEngine>(n, ChainEngine::Dense));
+    std::vector<std::vector<std::unique_ptr<Sketch>>> sketch(n);
+    for (int i = 0; i < n; ++i) {
+        sketch[i].resize(n);
+        sketch[i][i].reset(new Sketch(sketchOf(factors[i])));
+        density[i][i] = sketch[i][i]->density();
+    }
+
+    for (int length = 2; length <= n; ++length) {
+        for (int i = 0; i + length - 1 < n; ++i) {
+            int j = i + length - 1;
+            cost[i][j] = std::numeric_limits<double>::infinity();
+            double bestFlops = 0.0;
+            for (int s = i; s < j; ++s) {
+                const Sketch& L = *sketch[i][s];
+                const Sketch& R = *sketch[s + 1][j];
+                double flops = sparseFlops(L, R);
+                double cells = static_cast<double>(L.rows) * R.cols;
+                std::pair<ChainEngine, double> choice =
+                    cheapestEngine(L, R, flops, cells * coverage(flops, cells), length == n);
+                double total = cost[i][s] + cost[s + 1][j] + choice.second;
+                if (total < cost[i][j]) {
+                    cost[i][j] = total;
+                    stepCost[i][j] = choice.second;
+                    split[i][j] = s;
+                    engine[i][j] = choice.first;
+                    bestFlops = flops;
+                }
+            }
+            int s = split[i][j];
+            sketch[i][j].reset(new Sketch(sketchProduct(*sketch[i][s], *sketch[s + 1][j], bestFlops,
+                                                        engine[i][j] == ChainEngine::Sparse)));
+            density[i][j] = sketch[i][j]->density();
+        }
+    }
+
+    ChainPlan plan;
+    plan.factorCount = n;
+    plan.estimatedCost = cost[0][n - 1];
+    emitSteps(split, engine, stepCost, density, 0, n - 1, plan);
+    return plan;
+}
+
+// Run the steps in order. A step result is dropped as soon as the step that
+// consumes it has run, and the storage of dense results is handed to the next
+// dense step. Sparse steps keep their result in CSR for the steps after them.
+Matrix executeMatrixChain(const std::vector<ChainOperand>& factors, const ChainPlan& plan) {
+    int n = static_cast<int>(factors.size());
+    if (plan.factorCount != n || static_cast<int>(plan.steps.size()) != n - 1) {
+        throw std::invalid_argument("Chain plan does not match the factors.");
+    }
+    if (plan.steps.empty()) {
+        return factors[0].toDense();
+    }
+
+    std::vector<ChainOperand> results;
+    results.reserve(plan.steps.size());
+    std::vector<Matrix> spare; // Storage of consumed dense results
+    auto operand = [&](int index) -> const ChainOperand& {
+        return index < n ? factors[index] : results[index - n];
+    };
+    auto recycle = [&](int index) {
+        if (index >= n) {
+            ChainOperand& consumed = results[index - n];
+            if (!consumed.isSparse()) {
+                spare.push_back(consumed.takeDense());
+            }
+            consumed = ChainOperand(Matrix(0, 0));
+        }
+    };
+
+    for (const ChainStep& step : plan.steps) {
+        const ChainOperand& L = operand(step.left);
+        const ChainOperand& R = operand(step.right);
+        if (L.getCols() != R.getRows()) {
+            throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+        }
+
+        if (step.engine == ChainEngine::Sparse) {
+            CSRMatrix scratchL(0, 0);
+            CSRMatrix scratchR(0, 0);
+            results.push_back(ChainOperand(sparseSparseMultiplyCSR(sparseOf(L, scratchL), sparseOf(R, scratchR))));
+        } else {
+            Matrix scratchL(0, 0);
+            Matrix scratchR(0, 0);
+            const Matrix& denseL = denseOf(L, scratchL);
+            const Matrix& denseR = denseOf(R, scratchR);
+            Matrix product(0, 0);
+            if (step.engine == ChainEngine::Dense) {
+                if (!spare.empty()) {
+                    product = std::move(spare.back());
+                    spare.pop_back();
+                }
+                denseInto(denseL, denseR, product);
+            } else {
+                product = cache_optimized_multiply_dense_sparse(denseL, denseR);
+            }
+            results.push_back(ChainOperand(std::move(product)));
+        }
+        recycle(step.left);
+        recycle(step.right);
+    }
+
+    ChainOperand& last = results.back();
+    return last.isSparse() ? last.toDense() : last.takeDense();
+}
+
+// Plan and run a chain
+Matrix multiplyMatrixChain(const std::vector<ChainOperand>& factors) {
+    return executeMatrixChain(factors, planMatrixChain(factors));
+}
@@ -0,0 +1,84 @@
+#ifndef MATRIX_CHAIN_HPP
+#define MATRIX_CHAIN_HPP
+
+#include "csr_matrix.hpp"
+#include "matrix.hpp"
+#include <string>
+#include <vector>
+
+// Engine used for one product of a chain
+enum class ChainEngine {
+    Dense,  // Register-blocked SIMD kernel on the shared thread pool
+    Tiled,  // Tile-map engine (cache_optimized_multiply_dense_sparse)
+    Sparse  // CSR SpGEMM (sparseSparseMultiplyCSR)
+};
+
+// Factor of a chain: a dense matrix or a CSR matrix. A sparse factor is
+// planned from its exact non-zero counts and only densified by a step that
+// runs a dense engine on it.
+class ChainOperand {
+public:
+    ChainOperand(const Matrix& dense);
+    ChainOperand(Matrix&& dense);
+    ChainOperand(const CSRMatrix& sparse);
+    ChainOperand(CSRMatrix&& sparse);
+
+    // True for a CSR operand
+    bool isSparse() const;
+
+    // Get number of rows
+    int getRows() const;
+
+    // Get number of columns
+    int getCols() const;
+
+    // The stored matrix (getDense() for dense operands, getSparse() for CSR ones)
+    const Matrix& getDense() const;
+    const CSRMatrix& getSparse() const;
+
+    // Dense copy, whatever the format
+    Matrix toDense() const;
+
+    // Move the dense matrix out, leaving an empty operand (dense operands only)
+    Matrix takeDense();
+
+private:
+    bool sparse;
+    Matrix dense;
+    CSRMatrix csr;
+};
+
+// One product of a chain plan. Operand indices below the number of factors
+// refer to the factors; index factorCount + s refers to the result of step s.
+struct ChainStep {
+    int left;
+    int right;
+    ChainEngine engine;      // Sparse steps leave their result in CSR
+    double estimatedCost;    // Cost model units (about one dense flop each)
+    double estimatedDensity; // Predicted fraction of non-zero elements of the result
+};
+
+// Evaluation order of a chain, with steps listed in execution order
+struct ChainPlan {
+    int factorCount;
+    std::vector<ChainStep> steps;
+    double estimatedCost;
+
+    // Parenthesization with engines, e.g. "((M0 M1)[sparse] M2)[dense]"
+    std::string toString() const;
+};
+
+// Choose the parenthesization and engines for factors[0] * ... * factors[n-1].
+// Densities of intermediates are estimated from per-row and per-column
+// non-zero counts of the factors, and a dynamic program minimizes the
+// modelled cost (flops, memory traffic and format conversions, which depend
+// on whether each operand is dense or CSR).
+ChainPlan planMatrixChain(const std::vector<ChainOperand>& factors);
+
+// Run a plan; intermediate buffers are recycled once they have been consumed
+Matrix executeMatrixChain(const std::vector<ChainOperand>& factors, const ChainPlan& plan);
+
+// Plan and run factors[0] * ... * factors[n-1]
+Matrix multiplyMatrixChain(const std::vector<ChainOperand>& factors);
+
+#endif // MATRIX_CHAIN_HPP
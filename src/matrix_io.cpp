@@ -0,0 +1,67 @@
+#include "matrix_io.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+const char kMagic[4] = {'M', 'B', 'M', 'X'};
+
+} // namespace
+
+// Write a matrix to a binary file
+void saveMatrixBinary(const Matrix& M, const std::string& path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open " + path + " for writing.");
+    }
+
+    int32_t dims[2] = {M.getRows(), M.getCols()};
+    out.write(kMagic, sizeof(kMagic));
+    out.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+    for (int i = 0; i < M.getRows(); ++i) {
+        out.write(reinterpret_cast<const char*>(M.rowData(i)), sizeof(double) * M.getCols());
+    }
+    if (!out) {
+        throw std::runtime_error("Failed to write " + path + ".");
+    }
+}
+
+// Read a matrix from a binary file
+Matrix loadMatrixBinary(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open " + path + " for reading.");
+    }
+
+    char magic[4];
+    int32_t dims[2];
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(dims), sizeof(dims));
+    if (!in || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error(path + " is not a binary matrix file.");
+    }
+    if (dims[0] < 0 || dims[1] < 0) {
+        throw std::runtime_error(path + " has invalid dimensions.");
+    }
+
+    // Check the claimed size against the file before allocating for it
+    std::streampos dataStart = in.tellg();
+    in.seekg(0, std::ios::end);
+    std::streamoff available = in.tellg() - dataStart;
+    in.seekg(dataStart);
+    if (!in || static_cast<uint64_t>(dims[0]) * static_cast<uint64_t>(dims[1]) * sizeof(double) >
+                   static_cast<uint64_t>(available)) {
+        throw std::runtime_error(path + " is truncated.");
+    }
+
+    Matrix M(dims[0], dims[1]);
+    for (int i = 0; i < M.getRows(); ++i) {
+        in.read(reinterpret_cast<char*>(M.rowData(i)), sizeof(double) * M.getCols());
+    }
+    if (!in) {
+        throw std::runtime_error(path + " is truncated.");
+    }
+    return M;
+}
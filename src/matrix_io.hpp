@@ -0,0 +1,17 @@
+#ifndef MATRIX_IO_HPP
+#define MATRIX_IO_HPP
+
+#include "matrix.hpp"
+#include <string>
+
+// Binary matrix file: the 4-byte magic "MBMX", rows and cols as 32-bit
+// integers, then rows * cols doubles in row-major order (host byte order).
+// Both functions throw std::runtime_error when the file cannot be used.
+
+// Write a matrix to a binary file
+void saveMatrixBinary(const Matrix& M, const std::string& path);
+
+// Read a matrix from a binary file
+Matrix loadMatrixBinary(const std::string& path);
+
+#endif // MATRIX_IO_HPP
@@ -0,0 +1,55 @@
+#include "matrix_view.hpp"
+#include "matrix.hpp"
+#include <stdexcept>
+
+// View of a whole matrix
+MatrixView::MatrixView(const Matrix& M)
+    : base(M.getRows() > 0 && M.getCols() > 0 ? M.rowData(0) : nullptr),
+      storedRows(M.getRows()), storedCols(M.getCols()), ld(M.getCols()), transposed(false) {}
+
+// View of raw storage
+MatrixView::MatrixView(const double* data, int rows, int cols, int ld, bool transposed)
+    : base(data), storedRows(rows), storedCols(cols), ld(ld), transposed(transposed) {
+    if (rows < 0 || cols < 0 || (rows > 1 && ld < cols)) {
+        throw std::invalid_argument("Invalid matrix view dimensions.");
+    }
+}
+
+// Access individual elements
+double MatrixView::get(int row, int col) const {
+    if (row < 0 || row >= getRows() || col < 0 || col >= getCols()) {
+        throw std::out_of_range("Matrix index out of range");
+    }
+    return base[row * rowStride() + col * colStride()];
+}
+
+// Sub-block view
+MatrixView MatrixView::view(int r0, int c0, int r, int c) const {
+    if (r0 < 0 || c0 < 0 || r < 0 || c < 0 || r0 + r > getRows() || c0 + c > getCols()) {
+        throw std::out_of_range("Matrix view out of range");
+    }
+    const double* start = (r > 0 && c > 0) ? base + r0 * rowStride() + c0 * colStride() : base;
+    if (transposed) {
+        return MatrixView(start, c, r, ld, true);
+    }
+    return MatrixView(start, r, c, ld, false);
+}
+
+// Transposed view
+MatrixView MatrixView::transpose() const {
+    return MatrixView(base, storedRows, storedCols, ld, !transposed);
+}
+
+// Copy into a new row-major matrix
+Matrix MatrixView::toMatrix() const {
+    Matrix result(getRows(), getCols());
+    for (int i = 0; i < getRows(); ++i) {
+        double* out = result.rowData(i);
+        const double* in = base + i * rowStride();
+        long long step = colStride();
+        for (int j = 0; j < getCols(); ++j) {
+            out[j] = in[j * step];
+        }
+    }
+    return result;
+}
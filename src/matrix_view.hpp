@@ -0,0 +1,59 @@
+#ifndef MATRIX_VIEW_HPP
+#define MATRIX_VIEW_HPP
+
+class Matrix;
+
+// Non-owning, read-only window onto row-major storage: rows x cols elements
+// starting at data, with consecutive stored rows ld elements apart. A
+// transposed view swaps the roles of rows and columns without moving data.
+// Views are cheap to copy and must not outlive the storage they point into.
+//
+// Element (i, j) of the view lives at data()[i * rowStride() + j * colStride()].
+class MatrixView {
+public:
+    // View of a whole matrix (implicit, so engines taking a view accept a Matrix)
+    MatrixView(const Matrix& M);
+
+    // View of raw row-major storage (rows and cols before transposing)
+    MatrixView(const double* data, int rows, int cols, int ld, bool transposed = false);
+
+    // Get number of rows (after the transpose, if any)
+    int getRows() const { return transposed ? storedCols : storedRows; }
+
+    // Get number of columns (after the transpose, if any)
+    int getCols() const { return transposed ? storedRows : storedCols; }
+
+    // Distance between consecutive stored rows
+    int getLeadingDimension() const { return ld; }
+
+    // True when the view reads the storage transposed
+    bool isTransposed() const { return transposed; }
+
+    // Address of element (0, 0)
+    const double* data() const { return base; }
+
+    // Element steps between consecutive rows and columns of the view
+    long long rowStride() const { return transposed ? 1 : ld; }
+    long long colStride() const { return transposed ? ld : 1; }
+
+    // Access individual elements (bounds checked)
+    double get(int row, int col) const;
+
+    // Sub-block of r x c elements starting at (r0, c0), in O(1)
+    MatrixView view(int r0, int c0, int r, int c) const;
+
+    // Transposed view, in O(1)
+    MatrixView transpose() const;
+
+    // Copy into a new row-major matrix
+    Matrix toMatrix() const;
+
+private:
+    const double* base;
+    int storedRows;
+    int storedCols;
+    int ld;
+    bool transposed;
+};
+
+#endif // MATRIX_VIEW_HPP
@@ -0,0 +1,220 @@
+#include "morton_matrix.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Tile products below which a row or column split is not worth a task
+const double kParallelTileProducts = 8.0;
+
+// Spread the low 16 bits of v to the even bit positions
+inline uint32_t spreadBits(uint32_t v) {
+    v &= 0xFFFF;
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+// Morton code of tile (ti, tj); the row index takes the odd bits
+inline uint64_t mortonCode(int ti, int tj) {
+    uint64_t hi = (static_cast<uint64_t>(spreadBits(static_cast<uint32_t>(ti) >> 16)) << 1) |
+                  spreadBits(static_cast<uint32_t>(tj) >> 16);
+    uint64_t lo = (static_cast<uint64_t>(spreadBits(static_cast<uint32_t>(ti))) << 1) |
+                  spreadBits(static_cast<uint32_t>(tj));
+    return (hi << 32) | lo;
+}
+
+// Half of the smallest power of two covering length (length >= 2), so every
+// split stays aligned with the Morton quadrants
+inline int splitPoint(int length) {
+    int power = 1;
+    while (power < length) {
+        power <<= 1;
+    }
+    return power / 2;
+}
+
+struct Range {
+    int begin;
+    int end;
+    int length() const { return end - begin; }
+};
+
+// C[ri, rj] += A[ri, rk] * B[rk, rj] over tile ranges
+void multiplyRecursive(const MortonMatrix& A, const MortonMatrix& B, MortonMatrix& C,
+                       Range ri, Range rj, Range rk) {
+    int t = A.getTileSize();
+    if (ri.length() == 1 && rj.length() == 1 && rk.length() == 1) {
+        simd_gemm_block(t, t, t, A.tileData(ri.begin, rk.begin), t,
+                        B.tileData(rk.begin, rj.begin), t, C.tileData(ri.begin, rj.begin), t);
+        return;
+    }
+
+    double products = static_cast<double>(ri.length()) * rj.length() * rk.length();
+    int largest = std::max(ri.length(), std::max(rj.length(), rk.length()));
+    if (rk.length() == largest) {
+        // Both halves update the same tiles of C, so they run one after the other
+        int mid = rk.begin + splitPoint(rk.length());
+        multiplyRecursive(A, B, C, ri, rj, Range{rk.begin, mid});
+        multiplyRecursive(A, B, C, ri, rj, Range{mid, rk.end});
+        return;
+    }
+
+    // Row or column split: the halves write disjoint tiles of C
+    bool splitRows = ri.length() == largest;
+    Range whole = splitRows ? ri : rj;
+    int mid = whole.begin + splitPoint(whole.length());
+    Range halves[2] = {Range{whole.begin, mid}, Range{mid, whole.end}};
+    auto half = [&](int h) {
+        if (splitRows) {
+            multiplyRecursive(A, B, C, halves[h], rj, rk);
+        } else {
+            multiplyRecursive(A, B, C, ri, halves[h], rk);
+        }
+    };
+    if (products >= kParallelTileProducts) {
+        sharedThreadPool().parallelFor(0, 2, 1, [&](int lo, int hi) {
+            for (int h = lo; h < hi; ++h) {
+                half(h);
+            }
+        });
+    } else {
+        half(0);
+        half(1);
+    }
+}
+
+} // namespace
+
+// Constructor
+MortonMatrix::MortonMatrix(int r, int c, int tileSize)
+    : rows(r), cols(c), tileSize(tileSize) {
+    if (tileSize <= 0) {
+        throw std::invalid_argument("Tile size must be positive.");
+    }
+    tileRows = (rows + tileSize - 1) / tileSize;
+    tileCols = (cols + tileSize - 1) / tileSize;
+
+    // Number the tiles in Morton order of their grid position
+    std::vector<std::pair<uint64_t, int>> order;
+    order.reserve(static_cast<size_t>(tileRows) * tileCols);
+    for (int ti = 0; ti < tileRows; ++ti) {
+        for (int tj = 0; tj < tileCols; ++tj) {
+            order.push_back(std::make_pair(mortonCode(ti, tj), ti * tileCols + tj));
+        }
+    }
+    std::sort(order.begin(), order.end());
+
+    size_t tileElements = static_cast<size_t>(tileSize) * tileSize;
+    tileOffset.resize(order.size());
+    for (size_t n = 0; n < order.size(); ++n) {
+        tileOffset[order[n].second] = n * tileElements;
+    }
+    data.assign(order.size() * tileElements, 0.0);
+}
+
+// Build from a row-major matrix
+MortonMatrix::MortonMatrix(const MatrixView& dense, int tileSize)
+    : MortonMatrix(dense.getRows(), dense.getCols(), tileSize) {
+    sharedThreadPool().parallelFor(0, tileRows, 1, [&](int lo, int hi) {
+        for (int ti = lo; ti < hi; ++ti) {
+            int height = std::min(this->tileSize, rows - ti * this->tileSize);
+            for (int tj = 0; tj < tileCols; ++tj) {
+                int width = std::min(this->tileSize, cols - tj * this->tileSize);
+                double* tile = tileData(ti, tj);
+                const double* block = dense.data() + ti * this->tileSize * dense.rowStride() +
+                                      tj * this->tileSize * dense.colStride();
+                for (int r = 0; r < height; ++r) {
+                    const double* src = block + r * dense.rowStride();
+                    for (int c = 0; c < width; ++c) {
+                        tile[r * this->tileSize + c] = src[c * dense.colStride()];
+                    }
+                }
+            }
+        }
+    });
+}
+
+// Convert back to a row-major matrix
+Matrix MortonMatrix::toDense() const {
+    Matrix dense(rows, cols);
+    sharedThreadPool().parallelFor(0, tileRows, 1, [&](int lo, int hi) {
+        for (int ti = lo; ti < hi; ++ti) {
+            int height = std::min(tileSize, rows - ti * tileSize);
+            for (int tj = 0; tj < tileCols; ++tj) {
+                int width = std::min(tileSize, cols - tj * tileSize);
+                const double* tile = tileData(ti, tj);
+                for (int r = 0; r < height; ++r) {
+                    std::copy(tile + r * tileSize, tile + r * tileSize + width,
+                              dense.rowData(ti * tileSize + r) + tj * tileSize);
+                }
+            }
+        }
+    });
+    return dense;
+}
+
+// Get number of rows
+int MortonMatrix::getRows() const {
+    return rows;
+}
+
+// Get number of columns
+int MortonMatrix::getCols() const {
+    return cols;
+}
+
+// Get the tile edge length
+int MortonMatrix::getTileSize() const {
+    return tileSize;
+}
+
+// Get number of tile rows
+int MortonMatrix::getTileRows() const {
+    return tileRows;
+}
+
+// Get number of tile columns
+int MortonMatrix::getTileCols() const {
+    return tileCols;
+}
+
+// Start of tile (ti, tj)
+const double* MortonMatrix::tileData(int ti, int tj) const {
+    return data.data() + tileOffset[static_cast<size_t>(ti) * tileCols + tj];
+}
+
+double* MortonMatrix::tileData(int ti, int tj) {
+    return data.data() + tileOffset[static_cast<size_t>(ti) * tileCols + tj];
+}
+
+// Cache-oblivious recursive multiplication
+MortonMatrix mortonMultiply(const MortonMatrix& A, const MortonMatrix& B) {
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+    if (A.getTileSize() != B.getTileSize()) {
+        throw std::invalid_argument("Morton matrices must use the same tile size.");
+    }
+
+    MortonMatrix C(A.getRows(), B.getCols(), A.getTileSize());
+    if (A.getTileRows() > 0 && B.getTileCols() > 0 && A.getTileCols() > 0) {
+        multiplyRecursive(A, B, C, Range{0, A.getTileRows()}, Range{0, B.getTileCols()},
+                          Range{0, A.getTileCols()});
+    }
+    return C;
+}
+
+// Row-major in and out, Morton layout in between
+Matrix cacheObliviousMultiply(const MatrixView& A, const MatrixView& B) {
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+    return mortonMultiply(MortonMatrix(A), MortonMatrix(B)).toDense();
+}
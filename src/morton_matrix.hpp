@@ -0,0 +1,60 @@
+#ifndef MORTON_MATRIX_HPP
+#define MORTON_MATRIX_HPP
+
+#include "matrix.hpp"
+#include <vector>
+
+// Matrix stored as tileSize x tileSize tiles (each dense and row-major, edge
+// tiles zero-padded) laid out along a Morton (Z-order) curve over the tile
+// grid. Every aligned power-of-two block of tiles is then contiguous in
+// memory, which is what the recursive multiply below relies on.
+class MortonMatrix {
+public:
+    // Constructor for an all-zero matrix
+    MortonMatrix(int r, int c, int tileSize = 32);
+
+    // Build from a matrix or view (transposed views are read in place)
+    explicit MortonMatrix(const MatrixView& dense, int tileSize = 32);
+
+    // Convert back to a row-major matrix
+    Matrix toDense() const;
+
+    // Get number of rows
+    int getRows() const;
+
+    // Get number of columns
+    int getCols() const;
+
+    // Get the tile edge length
+    int getTileSize() const;
+
+    // Get number of tile rows
+    int getTileRows() const;
+
+    // Get number of tile columns
+    int getTileCols() const;
+
+    // Start of tile (ti, tj), row-major with stride getTileSize()
+    const double* tileData(int ti, int tj) const;
+    double* tileData(int ti, int tj);
+
+private:
+    int rows;
+    int cols;
+    int tileSize;
+    int tileRows;
+    int tileCols;
+    std::vector<size_t> tileOffset; // Offset of each tile in data, indexed ti * tileCols + tj
+    std::vector<double> data;       // Tiles in Morton order
+};
+
+// Cache-oblivious product of two Morton matrices with the same tile size:
+// the largest of the three dimensions is halved recursively until a single
+// tile product remains, and the two halves of a row or column split run as
+// parallel tasks
+MortonMatrix mortonMultiply(const MortonMatrix& A, const MortonMatrix& B);
+
+// Convert to Morton layout, multiply with mortonMultiply and convert back
+Matrix cacheObliviousMultiply(const MatrixView& A, const MatrixView& B);
+
+#endif // MORTON_MATRIX_HPP
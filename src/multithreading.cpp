@@ -1,9 +1,15 @@
 #include "multithreading.hpp"
+#include "row_partition.hpp"
+#include "spgemm.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
 // Function to multiply a single row of A with B
-void multiplyRow(const Matrix& A, const Matrix& B, Matrix& result, int row) {
+void multiplyRow(const MatrixView& A, const MatrixView& B, Matrix& result, int row) {
+    TRACE_SCOPE_ARG("row", row);
     for (int col = 0; col < B.getCols(); ++col) {
         double sum = 0.0;
         for (int k = 0; k < A.getCols(); ++k) {
@@ -16,79 +22,108 @@ void multiplyRow(const Matrix& A, const Matrix& B, Matrix& result, int row) {
 }
 
 // Dense-Dense multiplication with multithreading
-Matrix denseDenseMultiplyThreaded(const Matrix& A, const Matrix& B) {
+Matrix denseDenseMultiplyThreaded(const MatrixView& A, const MatrixView& B) {
+    TRACE_SCOPE("denseDenseMultiplyThreaded");
     int rows = A.getRows();
     int cols = B.getCols();
     Matrix result(rows, cols);
     std::vector<std::thread> threads;
 
     for (int i = 0; i < rows; ++i) {
+        TRACE_SCOPE("spawnThread");
         threads.emplace_back(multiplyRow, std::ref(A), std::ref(B), std::ref(result), i);
     }
 
     for (auto& t : threads) {
+        TRACE_SCOPE("joinThread");
         t.join();
     }
 
     return result;
 }
 
-// Function to multiply a single row of A with a column of B (for sparse)
-void multiplyRowSparse(const Matrix& A, const Matrix& B, Matrix& result, int row) {
-    for (int col = 0; col < B.getCols(); ++col) {
-        double sum = 0.0;
-        for (int k = 0; k < A.getCols(); ++k) {
-            sum += A.get(row, k) * B.get(k, col);
+// Dense-Dense multiplication with a prepacked B on the shared thread pool
+Matrix denseDenseMultiplyThreadedPacked(const MatrixView& A, const PackedMatrix& B) {
+    return packedMultiply(A, B, true);
+}
+
+// Dense-Dense multiplication with a prepacked A on the shared thread pool
+Matrix denseDenseMultiplyThreadedPacked(const PackedMatrix& A, const MatrixView& B) {
+    return packedMultiply(A, B, true);
+}
+
+// Parts per pool thread, so the dynamic schedule can absorb estimation error
+const int kPartsPerThread = 4;
+
+// Function to add the non-zero elements [beginUnit, endUnit) of row `row` of A,
+// each times its row of B, to out (for sparse)
+void multiplyRowSparse(const Matrix& A, const Matrix& B, int row, long long beginUnit, long long endUnit,
+                       double* out) {
+    TRACE_SCOPE_ARG("row", row);
+    const double* aRow = A.rowData(row);
+    int cols = B.getCols();
+    long long unit = 0;
+    for (int k = 0; k < A.getCols() && unit < endUnit; ++k) {
+        double a = aRow[k];
+        if (a == 0.0) {
+            continue;
+        }
+        if (unit++ < beginUnit) {
+            continue;
+        }
+        const double* bRow = B.rowData(k);
+        for (int col = 0; col < cols; ++col) {
+            out[col] += a * bRow[col];
         }
-        result.set(row, col, sum);
     }
 }
 
-// Dense-Sparse multiplication with multithreading
+// Dense-Sparse multiplication with multithreading: rows are split by their
+// number of non-zero elements on the shared thread pool, so a few heavy rows
+// do not leave the other threads idle
 Matrix denseSparseMultiplyThreaded(const Matrix& A, const Matrix& B) {
+    TRACE_SCOPE("denseSparseMultiplyThreaded");
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
     int rows = A.getRows();
     int cols = B.getCols();
     Matrix result(rows, cols);
-    std::vector<std::thread> threads;
+    ThreadPool& pool = sharedThreadPool();
 
-    for (int i = 0; i < rows; ++i) {
-        threads.emplace_back(multiplyRowSparse, std::ref(A), std::ref(B), std::ref(result), i);
-    }
+    std::vector<long long> rowWork(rows, 0);
+    pool.parallelFor(0, rows, 256, [&](int lo, int hi) {
+        for (int i = lo; i < hi; ++i) {
+            const double* aRow = A.rowData(i);
+            for (int k = 0; k < A.getCols(); ++k) {
+                rowWork[i] += aRow[k] != 0.0;
+            }
+        }
+    });
 
-    for (auto& t : threads) {
-        t.join();
-    }
+    RowPartition partition(rowWork, pool.getThreadCount() * kPartsPerThread);
+    RowKernel kernel = [&](int row, long long beginUnit, long long endUnit, double* out) {
+        multiplyRowSparse(A, B, row, beginUnit, endUnit, out);
+    };
+    pool.parallelFor(0, partition.getPartCount(), 1, [&](int lo, int hi) {
+        for (int p = lo; p < hi; ++p) {
+            partition.runPart(p, result, kernel);
+        }
+    });
+    partition.merge(result);
 
     return result;
 }
 
-// Function to multiply a single row of A with a column of B (for sparse-sparse)
-void multiplyRowSparseSparse(const Matrix& A, const Matrix& B, Matrix& result, int row) {
-    for (int col = 0; col < B.getCols(); ++col) {
-        double sum = 0.0;
-        for (int k = 0; k < A.getCols(); ++k) {
-            if (A.get(row, k) != 0 && B.get(k, col) != 0) {  // Only compute if both are non-zero
-                sum += A.get(row, k) * B.get(k, col);
-            }
-        }
-        result.set(row, col, sum);
-    }
-}
-
-// Sparse-Sparse multiplication with multithreading
+// Sparse-Sparse multiplication with multithreading: converts both operands to
+// CSR and runs the two-phase parallel SpGEMM engine on the shared thread pool
 Matrix sparseSparseMultiplyThreaded(const Matrix& A, const Matrix& B) {
-    int rows = A.getRows();
-    int cols = B.getCols();
-    Matrix result(rows, cols);
-    std::vector<std::thread> threads;
-
-    for (int i = 0; i < rows; ++i) {
-        threads.emplace_back(multiplyRowSparseSparse, std::ref(A), std::ref(B), std::ref(result), i);
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
     }
 
-    for (auto& t : threads) {
-        t.join();
-    }
-
-    return result;
+    CSRMatrix sparseA(A);
+    CSRMatrix sparseB(B);
+    return sparseSparseMultiplyCSR(sparseA, sparseB).toDense();
 }
@@ -2,9 +2,12 @@
 #define MULTITHREADING_HPP
 
 #include "matrix.hpp"
+#include "packed_matrix.hpp"
 
 // Function declarations
-Matrix denseDenseMultiplyThreaded(const Matrix& A, const Matrix& B);
+Matrix denseDenseMultiplyThreaded(const MatrixView& A, const MatrixView& B);
+Matrix denseDenseMultiplyThreadedPacked(const MatrixView& A, const PackedMatrix& B);
+Matrix denseDenseMultiplyThreadedPacked(const PackedMatrix& A, const MatrixView& B);
 Matrix denseSparseMultiplyThreaded(const Matrix& A, const Matrix& B);
 Matrix sparseSparseMultiplyThreaded(const Matrix& A, const Matrix& B);
 
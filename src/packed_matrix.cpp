@@ -0,0 +1,259 @@
+#include "packed_matrix.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Depth of the k blocks, so a slice of a B panel (kDepthBlock x 8) stays in L1
+const int kDepthBlock = 256;
+
+// Rows of the result computed per task
+const int kRowBlock = 64;
+
+void checkSide(const PackedMatrix& M, PackSide expected) {
+    if (M.getSide() != expected) {
+        throw std::invalid_argument("Packed matrix was packed for the other operand.");
+    }
+}
+
+// Per-thread staging for transposed operands, so the kernels always read rows
+thread_local std::vector<double> staging;
+
+// Copy rows [i0, i0 + height) x columns [j0, j0 + width) of a view into
+// staging as a row-major block; returns its start
+const double* stageBlock(const MatrixView& M, int i0, int height, int j0, int width) {
+    staging.resize(static_cast<size_t>(height) * width);
+    for (int i = 0; i < height; ++i) {
+        const double* src = M.data() + (i0 + i) * M.rowStride() + j0 * M.colStride();
+        for (int j = 0; j < width; ++j) {
+            staging[static_cast<size_t>(i) * width + j] = src[j * M.colStride()];
+        }
+    }
+    return staging.data();
+}
+
+void runBlocks(int blocks, bool threaded, const std::function<void(int, int)>& body) {
+    if (threaded) {
+        sharedThreadPool().parallelFor(0, blocks, 1, body);
+    } else {
+        body(0, blocks);
+    }
+}
+
+} // namespace
+
+const int PackedMatrix::kPanelRows;
+const int PackedMatrix::kPanelCols;
+
+// Constructor
+PackedMatrix::PackedMatrix(const MatrixView& M, PackSide side)
+    : rows(M.getRows()), cols(M.getCols()), side(side) {
+    if (side == PackSide::Left) {
+        // Panel p, depth q, row r -> data[(p * cols + q) * kPanelRows + r]
+        panelCount = (rows + kPanelRows - 1) / kPanelRows;
+        data.assign(static_cast<size_t>(panelCount) * cols * kPanelRows, 0.0);
+        for (int i = 0; i < rows; ++i) {
+            const double* src = M.data() + i * M.rowStride();
+            double* dst = &data[static_cast<size_t>(i / kPanelRows) * cols * kPanelRows + i % kPanelRows];
+            for (int q = 0; q < cols; ++q) {
+                dst[static_cast<size_t>(q) * kPanelRows] = src[q * M.colStride()];
+            }
+        }
+    } else {
+        // Panel p, depth q, column c -> data[(p * rows + q) * kPanelCols + c]
+        panelCount = (cols + kPanelCols - 1) / kPanelCols;
+        data.assign(static_cast<size_t>(panelCount) * rows * kPanelCols, 0.0);
+        for (int q = 0; q < rows; ++q) {
+            const double* src = M.data() + q * M.rowStride();
+            for (int c = 0; c < cols; ++c) {
+                data[(static_cast<size_t>(c / kPanelCols) * rows + q) * kPanelCols + c % kPanelCols] =
+                    src[c * M.colStride()];
+            }
+        }
+    }
+}
+
+// Convert back to a dense matrix
+Matrix PackedMatrix::toDense() const {
+    Matrix dense(rows, cols);
+    for (int i = 0; i < rows; ++i) {
+        double* dst = dense.rowData(i);
+        for (int j = 0; j < cols; ++j) {
+            if (side == PackSide::Left) {
+                dst[j] = panel(i / kPanelRows)[j * kPanelRows + i % kPanelRows];
+            } else {
+                dst[j] = panel(j / kPanelCols)[i * kPanelCols + j % kPanelCols];
+            }
+        }
+    }
+    return dense;
+}
+
+// Get number of rows
+int PackedMatrix::getRows() const {
+    return rows;
+}
+
+// Get number of columns
+int PackedMatrix::getCols() const {
+    return cols;
+}
+
+// Get the side the matrix was packed for
+PackSide PackedMatrix::getSide() const {
+    return side;
+}
+
+// Get number of panels
+int PackedMatrix::getPanelCount() const {
+    return panelCount;
+}
+
+// Start of panel p
+const double* PackedMatrix::panel(int p) const {
+    size_t depth = side == PackSide::Left ? cols * static_cast<size_t>(kPanelRows)
+                                          : rows * static_cast<size_t>(kPanelCols);
+    return data.data() + p * depth;
+}
+
+// Pack rows [i0, i0 + height) x depth [p0, p0 + depth) of op(A) into left panels
+void packLeftPanels(const MatrixView& A, int i0, int height, int p0, int depth, std::vector<double>& out) {
+    const int panelRows = PackedMatrix::kPanelRows;
+    int panels = (height + panelRows - 1) / panelRows;
+    out.assign(static_cast<size_t>(panels) * panelRows * depth, 0.0);
+    const double* base = A.data() + i0 * A.rowStride() + p0 * A.colStride();
+    if (A.isTransposed()) {
+        // Columns of op(A) are contiguous: read along them
+        for (int p = 0; p < depth; ++p) {
+            const double* src = base + p * A.colStride();
+            for (int r = 0; r < height; ++r) {
+                out[(static_cast<size_t>(r / panelRows) * depth + p) * panelRows + r % panelRows] = src[r];
+            }
+        }
+        return;
+    }
+    for (int r = 0; r < height; ++r) {
+        const double* src = base + r * A.rowStride();
+        double* dst = &out[static_cast<size_t>(r / panelRows) * panelRows * depth + r % panelRows];
+        for (int p = 0; p < depth; ++p) {
+            dst[static_cast<size_t>(p) * panelRows] = src[p];
+        }
+    }
+}
+
+// Pack depth [p0, p0 + depth) x columns [j0, j0 + width) of op(B) into right panels
+void packRightPanels(const MatrixView& B, int p0, int depth, int j0, int width, std::vector<double>& out) {
+    const int panelCols = PackedMatrix::kPanelCols;
+    int panels = (width + panelCols - 1) / panelCols;
+    out.assign(static_cast<size_t>(panels) * panelCols * depth, 0.0);
+    const double* base = B.data() + p0 * B.rowStride() + j0 * B.colStride();
+    if (B.isTransposed()) {
+        // Columns of op(B) are contiguous: read along them
+        for (int j = 0; j < width; ++j) {
+            const double* src = base + j * B.colStride();
+            double* dst = &out[static_cast<size_t>(j / panelCols) * panelCols * depth + j % panelCols];
+            for (int p = 0; p < depth; ++p) {
+                dst[static_cast<size_t>(p) * panelCols] = src[p];
+            }
+        }
+        return;
+    }
+    for (int p = 0; p < depth; ++p) {
+        const double* src = base + p * B.rowStride();
+        for (int jp = 0; jp < panels; ++jp) {
+            int count = std::min(panelCols, width - jp * panelCols);
+            std::copy(src + jp * panelCols, src + jp * panelCols + count,
+                      &out[(static_cast<size_t>(jp) * depth + p) * panelCols]);
+        }
+    }
+}
+
+// A * B with B prepacked: row blocks of A run in parallel, each walking the
+// B panels one k block at a time. Rows of a transposed A are staged per block.
+Matrix packedMultiply(const MatrixView& A, const PackedMatrix& B, bool threaded) {
+    checkSide(B, PackSide::Right);
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
+    int m = A.getRows();
+    int k = A.getCols();
+    int n = B.getCols();
+    Matrix result(m, n);
+    if (m == 0 || n == 0 || k == 0) {
+        return result;
+    }
+
+    int blocks = (m + kRowBlock - 1) / kRowBlock;
+    runBlocks(blocks, threaded, [&](int lo, int hi) {
+        for (int block = lo; block < hi; ++block) {
+            int i0 = block * kRowBlock;
+            int height = std::min(kRowBlock, m - i0);
+            const double* aBlock = A.data() + i0 * A.rowStride();
+            int lda = A.getLeadingDimension();
+            if (A.isTransposed()) {
+                aBlock = stageBlock(A, i0, height, 0, k);
+                lda = k;
+            }
+            for (int p0 = 0; p0 < k; p0 += kDepthBlock) {
+                int depth = std::min(kDepthBlock, k - p0);
+                for (int jp = 0; jp < B.getPanelCount(); ++jp) {
+                    int j0 = jp * PackedMatrix::kPanelCols;
+                    simd_gemm_packed_b(height, std::min(PackedMatrix::kPanelCols, n - j0), depth,
+                                       aBlock + p0, lda,
+                                       B.panel(jp) + static_cast<size_t>(p0) * PackedMatrix::kPanelCols,
+                                       result.rowData(i0) + j0, n);
+                }
+            }
+        }
+    });
+
+    return result;
+}
+
+// A * B with A prepacked: groups of A panels run in parallel, each streaming
+// one k block of B rows at a time. A transposed B is staged one k block at a time.
+Matrix packedMultiply(const PackedMatrix& A, const MatrixView& B, bool threaded) {
+    checkSide(A, PackSide::Left);
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
+    int m = A.getRows();
+    int k = A.getCols();
+    int n = B.getCols();
+    Matrix result(m, n);
+    if (m == 0 || n == 0 || k == 0) {
+        return result;
+    }
+
+    const int panelsPerBlock = kRowBlock / PackedMatrix::kPanelRows;
+    int blocks = (A.getPanelCount() + panelsPerBlock - 1) / panelsPerBlock;
+    runBlocks(blocks, threaded, [&](int lo, int hi) {
+        for (int block = lo; block < hi; ++block) {
+            int firstPanel = block * panelsPerBlock;
+            int lastPanel = std::min(firstPanel + panelsPerBlock, A.getPanelCount());
+            for (int p0 = 0; p0 < k; p0 += kDepthBlock) {
+                int depth = std::min(kDepthBlock, k - p0);
+                const double* bRows = B.data() + p0 * B.rowStride();
+                int ldb = B.getLeadingDimension();
+                if (B.isTransposed()) {
+                    bRows = stageBlock(B, p0, depth, 0, n);
+                    ldb = n;
+                }
+                for (int ip = firstPanel; ip < lastPanel; ++ip) {
+                    int i0 = ip * PackedMatrix::kPanelRows;
+                    simd_gemm_packed_a(std::min(PackedMatrix::kPanelRows, m - i0), n, depth,
+                                       A.panel(ip) + static_cast<size_t>(p0) * PackedMatrix::kPanelRows,
+                                       bRows, ldb, result.rowData(i0), n);
+                }
+            }
+        }
+    });
+
+    return result;
+}
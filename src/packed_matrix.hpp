@@ -0,0 +1,67 @@
+#ifndef PACKED_MATRIX_HPP
+#define PACKED_MATRIX_HPP
+
+#include "matrix.hpp"
+#include <vector>
+
+// Which operand of A * B a matrix is packed for
+enum class PackSide {
+    Left,  // A: panels of kPanelRows rows, stored one column of the panel at a time
+    Right  // B: panels of kPanelCols columns, stored one row of the panel at a time
+};
+
+// Operand prepacked into the panel layout read by the SIMD micro-kernels
+// (simd_gemm_packed_a / simd_gemm_packed_b). Pack a matrix that is multiplied
+// many times once, then pass the PackedMatrix to the engines instead of the
+// Matrix so the packing cost is not paid on every call. Edge panels are
+// zero-padded.
+class PackedMatrix {
+public:
+    // Height of a left panel and width of a right panel (the micro-kernel tile)
+    static const int kPanelRows = 4;
+    static const int kPanelCols = 8;
+
+    // Constructor: pack M (any view, so op(M) packs without a copy) for the given side
+    PackedMatrix(const MatrixView& M, PackSide side);
+
+    // Convert back to a dense matrix
+    Matrix toDense() const;
+
+    // Get number of rows
+    int getRows() const;
+
+    // Get number of columns
+    int getCols() const;
+
+    // Get the side the matrix was packed for
+    PackSide getSide() const;
+
+    // Get number of panels
+    int getPanelCount() const;
+
+    // Start of panel p (panel p of a left matrix covers rows p * kPanelRows onward,
+    // of a right matrix columns p * kPanelCols onward)
+    const double* panel(int p) const;
+
+private:
+    int rows;
+    int cols;
+    PackSide side;
+    int panelCount;
+    std::vector<double> data; // Panels back to back
+};
+
+// Pack a block of a view into out in the left (kPanelRows-row) or right
+// (kPanelCols-column) panel layout, with panels depth elements deep; edge
+// panels are zero-padded. Used by engines that pack per block, reading
+// transposed views along their contiguous direction.
+void packLeftPanels(const MatrixView& A, int i0, int height, int p0, int depth, std::vector<double>& out);
+void packRightPanels(const MatrixView& B, int p0, int depth, int j0, int width, std::vector<double>& out);
+
+// A * B with B prepacked as the right operand
+Matrix packedMultiply(const MatrixView& A, const PackedMatrix& B, bool threaded = true);
+
+// A * B with A prepacked as the left operand
+Matrix packedMultiply(const PackedMatrix& A, const MatrixView& B, bool threaded = true);
+
+#endif // PACKED_MATRIX_HPP
@@ -18,7 +18,7 @@ void performCacheOptimizedTest(int rows, int cols, double sparsity) {
     A.fillRandom(sparsity);
     B.fillRandom(sparsity);
 
-    long long cacheMisses[1]; // Array to hold the number of cache misses
+    long long cacheMisses[2] = {0, 0}; // L1 data cache misses and dTLB misses
     int EventSet = PAPI_NULL; // Initialize PAPI Event Set
 
     // Create the event set
@@ -33,6 +33,9 @@ void performCacheOptimizedTest(int rows, int cols, double sparsity) {
         return;
     }
 
+    // Add the data TLB miss event when the CPU exposes it (counted in slot 1)
+    bool countTlbMisses = PAPI_add_event(EventSet, PAPI_TLB_DM) == PAPI_OK;
+
     struct rusage usage; // Structure to hold memory usage and CPU time information
     long peakMemoryUsage = 0; // Variable to hold peak memory usage
 
@@ -51,6 +54,9 @@ void performCacheOptimizedTest(int rows, int cols, double sparsity) {
 
     std::cout << "Cache-Optimized Dense-Dense Multiplication Time: " << denseDuration.count() << " seconds\n";
     std::cout << "Cache Misses: " << cacheMisses[0] << "\n";
+    if (countTlbMisses) {
+        std::cout << "dTLB Misses: " << cacheMisses[1] << "\n";
+    }
     std::cout << "User CPU Time: " << usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 << " seconds\n";
     std::cout << "System CPU Time: " << usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6 << " seconds\n";
     std::cout << "Peak Memory Usage: " << peakMemoryUsage << " KB\n";
@@ -70,6 +76,9 @@ void performCacheOptimizedTest(int rows, int cols, double sparsity) {
 
     std::cout << "Cache-Optimized Dense-Sparse Multiplication Time: " << denseDuration.count() << " seconds\n";
     std::cout << "Cache Misses: " << cacheMisses[0] << "\n";
+    if (countTlbMisses) {
+        std::cout << "dTLB Misses: " << cacheMisses[1] << "\n";
+    }
     std::cout << "User CPU Time: " << usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 << " seconds\n";
     std::cout << "System CPU Time: " << usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6 << " seconds\n";
     std::cout << "Peak Memory Usage: " << peakMemoryUsage << " KB\n";
@@ -89,10 +98,18 @@ void performCacheOptimizedTest(int rows, int cols, double sparsity) {
 
     std::cout << "Cache-Optimized Sparse-Sparse Multiplication Time: " << denseDuration.count() << " seconds\n";
     std::cout << "Cache Misses: " << cacheMisses[0] << "\n";
+    if (countTlbMisses) {
+        std::cout << "dTLB Misses: " << cacheMisses[1] << "\n";
+    }
     std::cout << "User CPU Time: " << usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 << " seconds\n";
     std::cout << "System CPU Time: " << usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6 << " seconds\n";
     std::cout << "Peak Memory Usage: " << peakMemoryUsage << " KB\n";
 
+    // Report how the large buffers were backed (see huge_pages.hpp)
+    HugePageStats pages = getHugePageStats();
+    std::cout << "Huge Page Buffers: " << pages.transparentAllocations << " transparent, "
+              << pages.explicitAllocations << " explicit, " << pages.fallbackAllocations << " fallback\n";
+
     // Cleanup PAPI resources
     PAPI_cleanup_eventset(EventSet);
     PAPI_destroy_eventset(&EventSet);
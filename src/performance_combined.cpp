@@ -0,0 +1,103 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <papi.h> // Include PAPI header
+#include "matrix.hpp"
+#include "combined_multiply.hpp" // Threads + cache blocking + SIMD
+#include "multithreading.hpp"
+#include "simd.hpp"
+#include "cache_optimization.hpp"
+
+// Largest element-wise difference between two matrices of the same shape
+double maxAbsDifference(const Matrix& X, const Matrix& Y) {
+    double worst = 0.0;
+    for (int i = 0; i < X.getRows(); ++i) {
+        const double* x = X.rowData(i);
+        const double* y = Y.rowData(i);
+        for (int j = 0; j < X.getCols(); ++j) {
+            worst = std::max(worst, std::fabs(x[j] - y[j]));
+        }
+    }
+    return worst;
+}
+
+// Compare the combined engine against the three standalone engines on the same operands
+void performTestCombined(int rows, int cols, double sparsity) {
+    // Initialize PAPI library
+    if (PAPI_library_init(PAPI_VER_CURRENT) != PAPI_VER_CURRENT) {
+        std::cerr << "PAPI library initialization failed!" << std::endl;
+        return;
+    }
+
+    Matrix A(rows, cols);
+    Matrix B(cols, rows); // Ensure B dimensions are compatible
+
+    // Fill matrices with random values based on sparsity
+    A.fillRandom(sparsity);
+    B.fillRandom(sparsity);
+
+    long long cacheMisses[2] = {0, 0}; // L1 data cache misses and dTLB misses
+    int EventSet = PAPI_NULL; // Initialize PAPI Event Set
+
+    // Create the event set
+    if (PAPI_create_eventset(&EventSet) != PAPI_OK) {
+        std::cerr << "PAPI create event set failed!" << std::endl;
+        return;
+    }
+
+    // Add the L1 data cache miss event to the event set
+    if (PAPI_add_event(EventSet, PAPI_L1_DCM) != PAPI_OK) {
+        std::cerr << "PAPI add event failed!" << std::endl;
+        return;
+    }
+
+    // Add the data TLB miss event when the CPU exposes it (counted in slot 1)
+    bool countTlbMisses = PAPI_add_event(EventSet, PAPI_TLB_DM) == PAPI_OK;
+
+    struct Engine {
+        const char* name;
+        std::function<Matrix(const Matrix&, const Matrix&)> run;
+    };
+    Engine engines[4] = {
+        {"Combined (threads + cache + SIMD)", combinedDenseMultiply},
+        {"Multithreading", denseDenseMultiplyThreaded},
+        {"SIMD", [](const Matrix& X, const Matrix& Y) { return simd_dense_dense_multiply(X, Y); }},
+        {"Cache optimization", [](const Matrix& X, const Matrix& Y) { return cache_optimized_multiply_dense_dense(X, Y); }}
+    };
+
+    double flops = 2.0 * rows * cols * rows;
+    double combinedTime = 0.0;
+    Matrix reference(0, 0);
+
+    for (int e = 0; e < 4; ++e) {
+        // Measure Dense-Dense Multiplication Time and Cache Misses
+        PAPI_start(EventSet); // Start counting
+        auto start = std::chrono::high_resolution_clock::now();
+        Matrix result = engines[e].run(A, B);
+        auto end = std::chrono::high_resolution_clock::now();
+        PAPI_stop(EventSet, cacheMisses); // Stop counting and get the cache misses
+
+        std::chrono::duration<double> duration = end - start;
+        if (e == 0) {
+            combinedTime = duration.count();
+            reference = result;
+        }
+
+        std::cout << engines[e].name << " Time: " << duration.count() << " seconds\n";
+        std::cout << "GFLOP/s: " << flops / duration.count() / 1e9 << "\n";
+        std::cout << "Cache Misses: " << cacheMisses[0] << "\n";
+        if (countTlbMisses) {
+            std::cout << "dTLB Misses: " << cacheMisses[1] << "\n";
+        }
+        if (e > 0) {
+            std::cout << "Combined speedup: " << duration.count() / combinedTime << "x\n";
+            std::cout << "Max difference from combined: " << maxAbsDifference(reference, result) << "\n";
+        }
+    }
+
+    // Cleanup PAPI resources
+    PAPI_cleanup_eventset(EventSet);
+    PAPI_destroy_eventset(&EventSet);
+    PAPI_shutdown();
+}
@@ -20,7 +20,7 @@ void performTestMultithreading(int rows, int cols, double sparsity) {
     A.fillRandom(sparsity);
     B.fillRandom(sparsity);
 
-    long long cacheMisses[1]; // Array to hold the number of cache misses
+    long long cacheMisses[2] = {0, 0}; // L1 data cache misses and dTLB misses
     int EventSet = PAPI_NULL; // Initialize PAPI Event Set
 
     // Create the event set
@@ -35,6 +35,9 @@ void performTestMultithreading(int rows, int cols, double sparsity) {
         return;
     }
 
+    // Add the data TLB miss event when the CPU exposes it (counted in slot 1)
+    bool countTlbMisses = PAPI_add_event(EventSet, PAPI_TLB_DM) == PAPI_OK;
+
     struct rusage usage; // Structure to hold memory usage information
     long peakMemoryUsage = 0; // Variable to hold peak memory usage
 
@@ -54,6 +57,9 @@ void performTestMultithreading(int rows, int cols, double sparsity) {
 
     std::cout << "Dense-Dense Multiplication Time (Threaded): " << denseDuration.count() << " seconds\n";
     std::cout << "Cache Misses: " << cacheMisses[0] << "\n";
+    if (countTlbMisses) {
+        std::cout << "dTLB Misses: " << cacheMisses[1] << "\n";
+    }
     std::cout << "User CPU Time: " << (double)(cpuEnd - cpuStart) / CLOCKS_PER_SEC << " seconds\n";
     std::cout << "Peak Memory Usage: " << peakMemoryUsage << " KB\n";
 
@@ -73,6 +79,9 @@ void performTestMultithreading(int rows, int cols, double sparsity) {
 
     std::cout << "Dense-Sparse Multiplication Time (Threaded): " << denseDuration.count() << " seconds\n";
     std::cout << "Cache Misses: " << cacheMisses[0] << "\n";
+    if (countTlbMisses) {
+        std::cout << "dTLB Misses: " << cacheMisses[1] << "\n";
+    }
     std::cout << "User CPU Time: " << (double)(cpuEnd - cpuStart) / CLOCKS_PER_SEC << " seconds\n";
     std::cout << "Peak Memory Usage: " << peakMemoryUsage << " KB\n";
 
@@ -92,6 +101,9 @@ void performTestMultithreading(int rows, int cols, double sparsity) {
 
     std::cout << "Sparse-Sparse Multiplication Time (Threaded): " << denseDuration.count() << " seconds\n";
     std::cout << "Cache Misses: " << cacheMisses[0] << "\n";
+    if (countTlbMisses) {
+        std::cout << "dTLB Misses: " << cacheMisses[1] << "\n";
+    }
     std::cout << "User CPU Time: " << (double)(cpuEnd - cpuStart) / CLOCKS_PER_SEC << " seconds\n";
     std::cout << "Peak Memory Usage: " << peakMemoryUsage << " KB\n";
 
@@ -20,7 +20,7 @@ void performTestSIMD(int rows, int cols, double sparsity) {
     A.fillRandom(sparsity);
     B.fillRandom(sparsity);
 
-    long long cacheMisses[1]; // Array to hold the number of cache misses
+    long long cacheMisses[2] = {0, 0}; // L1 data cache misses and dTLB misses
     int EventSet = PAPI_NULL; // Initialize PAPI Event Set
 
     // Create the event set
@@ -35,6 +35,9 @@ void performTestSIMD(int rows, int cols, double sparsity) {
         return;
     }
 
+    // Add the data TLB miss event when the CPU exposes it (counted in slot 1)
+    bool countTlbMisses = PAPI_add_event(EventSet, PAPI_TLB_DM) == PAPI_OK;
+
     struct rusage usage; // Structure to hold memory usage information
     long peakMemoryUsage = 0; // Variable to hold peak memory usage
 
@@ -60,6 +63,9 @@ void performTestSIMD(int rows, int cols, double sparsity) {
     std::cout << "User CPU Time: " << userCpuDuration << " seconds\n";
     std::cout << "System CPU Time: " << systemCpuDuration << " seconds\n";
     std::cout << "Cache Misses: " << cacheMisses[0] << "\n";
+    if (countTlbMisses) {
+        std::cout << "dTLB Misses: " << cacheMisses[1] << "\n";
+    }
     std::cout << "Peak Memory Usage: " << peakMemoryUsage << " KB\n";
 
     // Measure Dense-Sparse Multiplication Time, CPU Time, and Cache Misses
@@ -84,6 +90,9 @@ void performTestSIMD(int rows, int cols, double sparsity) {
     std::cout << "User CPU Time: " << userCpuDuration << " seconds\n";
     std::cout << "System CPU Time: " << systemCpuDuration << " seconds\n";
     std::cout << "Cache Misses: " << cacheMisses[0] << "\n";
+    if (countTlbMisses) {
+        std::cout << "dTLB Misses: " << cacheMisses[1] << "\n";
+    }
     std::cout << "Peak Memory Usage: " << peakMemoryUsage << " KB\n";
 
     // Measure Sparse-Sparse Multiplication Time, CPU Time, and Cache Misses
@@ -108,6 +117,9 @@ void performTestSIMD(int rows, int cols, double sparsity) {
     std::cout << "User CPU Time: " << userCpuDuration << " seconds\n";
     std::cout << "System CPU Time: " << systemCpuDuration << " seconds\n";
     std::cout << "Cache Misses: " << cacheMisses[0] << "\n";
+    if (countTlbMisses) {
+        std::cout << "dTLB Misses: " << cacheMisses[1] << "\n";
+    }
     std::cout << "Peak Memory Usage: " << peakMemoryUsage << " KB\n";
 
     // Cleanup PAPI resources
@@ -18,7 +18,7 @@ void performTest(int rows, int cols, double sparsity) {
     A.fillRandom(sparsity);
     B.fillRandom(sparsity);
 
-    long long cacheMisses[1]; // Array to hold the number of cache misses
+    long long cacheMisses[2] = {0, 0}; // L1 data cache misses and dTLB misses
     int EventSet = PAPI_NULL; // Initialize PAPI Event Set
 
     // Create the event set
@@ -33,6 +33,9 @@ void performTest(int rows, int cols, double sparsity) {
         return;
     }
 
+    // Add the data TLB miss event when the CPU exposes it (counted in slot 1)
+    bool countTlbMisses = PAPI_add_event(EventSet, PAPI_TLB_DM) == PAPI_OK;
+
     struct rusage usage; // For CPU usage statistics
 
     // Measure Dense-Dense Multiplication Time and Cache Misses
@@ -47,6 +50,9 @@ void performTest(int rows, int cols, double sparsity) {
     getrusage(RUSAGE_SELF, &usage);
     std::cout << "Dense-Dense Multiplication Time: " << denseDuration.count() << " seconds\n";
     std::cout << "Cache Misses: " << cacheMisses[0] << "\n";
+    if (countTlbMisses) {
+        std::cout << "dTLB Misses: " << cacheMisses[1] << "\n";
+    }
     std::cout << "User CPU Time: " << usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 << " seconds\n";
     std::cout << "System CPU Time: " << usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6 << " seconds\n";
 
@@ -62,6 +68,9 @@ void performTest(int rows, int cols, double sparsity) {
     getrusage(RUSAGE_SELF, &usage);
     std::cout << "Dense-Sparse Multiplication Time: " << denseDuration.count() << " seconds\n";
     std::cout << "Cache Misses: " << cacheMisses[0] << "\n";
+    if (countTlbMisses) {
+        std::cout << "dTLB Misses: " << cacheMisses[1] << "\n";
+    }
     std::cout << "User CPU Time: " << usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 << " seconds\n";
     std::cout << "System CPU Time: " << usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6 << " seconds\n";
 
@@ -77,6 +86,9 @@ void performTest(int rows, int cols, double sparsity) {
     getrusage(RUSAGE_SELF, &usage);
     std::cout << "Sparse-Sparse Multiplication Time: " << denseDuration.count() << " seconds\n";
     std::cout << "Cache Misses: " << cacheMisses[0] << "\n";
+    if (countTlbMisses) {
+        std::cout << "dTLB Misses: " << cacheMisses[1] << "\n";
+    }
     std::cout << "User CPU Time: " << usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 << " seconds\n";
     std::cout << "System CPU Time: " << usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6 << " seconds\n";
 
@@ -0,0 +1,280 @@
+#include "product_cache.hpp"
+#include "matrix_io.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const uint64_t kHashPrime = 0x9E3779B97F4A7C15ULL;
+
+// Final avalanche step (from SplitMix64)
+inline uint64_t mix64(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+inline uint64_t doubleBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+} // namespace
+
+// 64-bit content hash of a matrix. Four independent lanes keep the multiply
+// chains short so hashing runs close to memory speed.
+uint64_t hashMatrix(const Matrix& M) {
+    uint64_t lanes[4] = {0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL,
+                         0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL};
+    size_t count = static_cast<size_t>(M.getRows()) * M.getCols();
+    if (count > 0) {
+        const double* data = M.rowData(0); // Rows are contiguous
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            for (int l = 0; l < 4; ++l) {
+                lanes[l] = (lanes[l] ^ doubleBits(data[i + l])) * kHashPrime;
+                lanes[l] ^= lanes[l] >> 29;
+            }
+        }
+        for (; i < count; ++i) {
+            lanes[0] = (lanes[0] ^ doubleBits(data[i])) * kHashPrime;
+            lanes[0] ^= lanes[0] >> 29;
+        }
+    }
+
+    uint64_t h = mix64((static_cast<uint64_t>(M.getRows()) << 32) ^ static_cast<uint32_t>(M.getCols()));
+    for (int l = 0; l < 4; ++l) {
+        h = mix64(h ^ lanes[l]);
+    }
+    return h;
+}
+
+bool ProductKey::operator==(const ProductKey& other) const {
+    return hashA == other.hashA && hashB == other.hashB && rowsA == other.rowsA &&
+           colsA == other.colsA && colsB == other.colsB && engine == other.engine;
+}
+
+size_t ProductKeyHash::operator()(const ProductKey& key) const {
+    uint64_t h = mix64(key.hashA ^ mix64(key.hashB));
+    return static_cast<size_t>(h ^ std::hash<std::string>()(key.engine));
+}
+
+// Constructor
+ProductCache::ProductCache(size_t memoryBudgetBytes, const std::string& spillDir, size_t diskBudgetBytes)
+    : memoryBudget(memoryBudgetBytes), diskBudget(diskBudgetBytes > 0 ? diskBudgetBytes : 4 * memoryBudgetBytes),
+      spillDir(spillDir), stats() {
+    // Spill writes fail quietly later on, so a directory they cannot use is an error here
+    if (!spillDir.empty()) {
+        if (mkdir(spillDir.c_str(), 0755) != 0 && errno != EEXIST) {
+            throw std::runtime_error("Could not create the spill directory " + spillDir + ".");
+        }
+        struct stat info;
+        if (stat(spillDir.c_str(), &info) != 0 || !S_ISDIR(info.st_mode) ||
+            access(spillDir.c_str(), W_OK | X_OK) != 0) {
+            throw std::runtime_error("Spill directory " + spillDir + " is not a writable directory.");
+        }
+    }
+}
+
+// Destructor
+ProductCache::~ProductCache() {
+    clear();
+}
+
+// Build the key of A * B for engineName
+ProductKey ProductCache::makeKey(const Matrix& A, const Matrix& B, const std::string& engineName) {
+    ProductKey key;
+    key.hashA = hashMatrix(A);
+    key.hashB = hashMatrix(B);
+    key.rowsA = A.getRows();
+    key.colsA = A.getCols();
+    key.colsB = B.getCols();
+    key.engine = engineName;
+    return key;
+}
+
+// Return A * B from the cache, or compute and remember it
+Matrix ProductCache::multiply(const Matrix& A, const Matrix& B, const std::string& engineName,
+                              const MultiplyEngine& engine) {
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
+    ProductKey key = makeKey(A, B, engineName);
+    Matrix product(0, 0);
+    if (lookup(key, product)) {
+        return product;
+    }
+
+    product = engine(A, B);
+    insert(key, product);
+    return product;
+}
+
+// Look a product up (memory first, then the spill directory)
+bool ProductCache::lookup(const ProductKey& key, Matrix& product) {
+    std::string path;
+    std::shared_ptr<const Matrix> cached;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto found = index.find(key);
+        if (found != index.end()) {
+            lru.splice(lru.begin(), lru, found->second); // Mark as most recently used
+            cached = found->second->product;
+            ++stats.hits;
+        } else {
+            auto onDisk = spilled.find(key);
+            if (onDisk == spilled.end()) {
+                ++stats.misses;
+                return false;
+            }
+            spillLru.splice(spillLru.begin(), spillLru, onDisk->second);
+            path = onDisk->second->path;
+        }
+    }
+    if (cached) {
+        product = *cached; // Copy outside the lock; the entry stays alive through cached
+        return true;
+    }
+
+    // Reload outside the lock; a missing or damaged file is just a miss
+    try {
+        product = loadMatrixBinary(path);
+    } catch (const std::exception&) {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto onDisk = spilled.find(key);
+        if (onDisk != spilled.end()) {
+            dropSpillFile(onDisk->second);
+        }
+        ++stats.misses;
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        ++stats.spillHits;
+    }
+    insert(key, product); // Promote back into memory
+    return true;
+}
+
+// Store a product
+void ProductCache::insert(const ProductKey& key, const Matrix& product) {
+    size_t bytes = static_cast<size_t>(product.getRows()) * product.getCols() * sizeof(double) + sizeof(Matrix);
+    std::vector<Entry> victims;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto found = index.find(key);
+        if (found != index.end()) {
+            lru.splice(lru.begin(), lru, found->second);
+            return;
+        }
+
+        Entry entry;
+        entry.key = key;
+        entry.product = std::make_shared<const Matrix>(product);
+        entry.bytes = bytes;
+        if (bytes > memoryBudget) {
+            victims.push_back(entry); // Too large for memory; goes straight to disk
+        } else {
+            lru.push_front(entry);
+            index[key] = lru.begin();
+            stats.bytesInMemory += bytes;
+            while (stats.bytesInMemory > memoryBudget) {
+                Entry& oldest = lru.back();
+                stats.bytesInMemory -= oldest.bytes;
+                ++stats.evictions;
+                index.erase(oldest.key);
+                victims.push_back(oldest);
+                lru.pop_back();
+            }
+        }
+    }
+
+    // Spill evicted products that are not on disk yet, outside the lock
+    if (spillDir.empty()) {
+        return;
+    }
+    for (const Entry& victim : victims) {
+        if (victim.bytes > diskBudget) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            auto onDisk = spilled.find(victim.key);
+            if (onDisk != spilled.end()) {
+                spillLru.splice(spillLru.begin(), spillLru, onDisk->second);
+                continue;
+            }
+        }
+        std::string path = spillPath(victim.key);
+        try {
+            saveMatrixBinary(*victim.product, path);
+        } catch (const std::exception&) {
+            continue; // Disk tier is best effort
+        }
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (spilled.count(victim.key) > 0) {
+            continue; // Another thread spilled it meanwhile
+        }
+        SpillFile file;
+        file.key = victim.key;
+        file.path = path;
+        file.bytes = victim.bytes;
+        spillLru.push_front(file);
+        spilled[victim.key] = spillLru.begin();
+        stats.bytesOnDisk += victim.bytes;
+        ++stats.spillWrites;
+        while (stats.bytesOnDisk > diskBudget) {
+            ++stats.spillEvictions;
+            dropSpillFile(std::prev(spillLru.end()));
+        }
+    }
+}
+
+// Delete a spilled file and forget it (cacheMutex must be held)
+void ProductCache::dropSpillFile(std::list<SpillFile>::iterator file) {
+    std::remove(file->path.c_str());
+    stats.bytesOnDisk -= file->bytes;
+    spilled.erase(file->key);
+    spillLru.erase(file);
+}
+
+// Drop every entry (spilled files are deleted too)
+void ProductCache::clear() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    for (const SpillFile& file : spillLru) {
+        std::remove(file.path.c_str());
+    }
+    spilled.clear();
+    spillLru.clear();
+    stats.bytesOnDisk = 0;
+    index.clear();
+    lru.clear();
+    stats.bytesInMemory = 0;
+}
+
+// Snapshot of the counters
+ProductCacheStats ProductCache::getStats() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return stats;
+}
+
+// File name of a spilled product
+std::string ProductCache::spillPath(const ProductKey& key) const {
+    std::ostringstream name;
+    name << spillDir << "/" << std::hex << key.hashA << "_" << key.hashB << "_"
+         << ProductKeyHash()(key) << ".mbmx";
+    return name.str();
+}
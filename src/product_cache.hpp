@@ -0,0 +1,115 @@
+#ifndef PRODUCT_CACHE_HPP
+#define PRODUCT_CACHE_HPP
+
+#include "async_multiply.hpp"
+#include "matrix.hpp"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// 64-bit content hash of a matrix (dimensions and element bits), O(rows * cols)
+uint64_t hashMatrix(const Matrix& M);
+
+// Identity of a product: operand hashes (or caller-managed version stamps),
+// the operand shapes and the engine that computed it
+struct ProductKey {
+    uint64_t hashA;
+    uint64_t hashB;
+    int rowsA;
+    int colsA;
+    int colsB;
+    std::string engine;
+
+    bool operator==(const ProductKey& other) const;
+};
+
+struct ProductKeyHash {
+    size_t operator()(const ProductKey& key) const;
+};
+
+// Hit/miss counters of a product cache
+struct ProductCacheStats {
+    long long hits;        // Served from memory
+    long long spillHits;   // Served from the spill directory
+    long long misses;      // Computed
+    long long evictions;   // Dropped from memory to stay within budget
+    long long spillWrites; // Written to the spill directory on eviction
+    long long spillEvictions; // Deleted from the spill directory to stay within budget
+    size_t bytesInMemory;
+    size_t bytesOnDisk;
+};
+
+// Cache of matrix products keyed by operand content. Entries live in memory
+// under a byte budget with least-recently-used eviction; when a spill
+// directory is set, evicted products are written there in the binary matrix
+// format and reloaded on a later hit. The spill directory has its own byte
+// budget, also with least-recently-used eviction, and the files the cache
+// wrote are deleted when it is cleared or destroyed. Safe to share between
+// threads.
+class ProductCache {
+public:
+    // Constructor (empty spillDir disables the disk tier; a diskBudgetBytes of
+    // 0 allows four times the memory budget on disk). A missing spillDir is
+    // created (its parent must exist); throws std::runtime_error if it cannot
+    // be created or is not a writable directory.
+    explicit ProductCache(size_t memoryBudgetBytes, const std::string& spillDir = "",
+                          size_t diskBudgetBytes = 0);
+
+    // Destructor (deletes the spilled files)
+    ~ProductCache();
+
+    ProductCache(const ProductCache&) = delete;
+    ProductCache& operator=(const ProductCache&) = delete;
+
+    // Return A * B from the cache, or compute it with engine and remember it.
+    // engineName is part of the key, so different engines never share entries.
+    Matrix multiply(const Matrix& A, const Matrix& B, const std::string& engineName,
+                    const MultiplyEngine& engine);
+
+    // Build the key of A * B for engineName
+    static ProductKey makeKey(const Matrix& A, const Matrix& B, const std::string& engineName);
+
+    // Look a product up (memory first, then the spill directory)
+    bool lookup(const ProductKey& key, Matrix& product);
+
+    // Store a product
+    void insert(const ProductKey& key, const Matrix& product);
+
+    // Drop every entry (spilled files are deleted too)
+    void clear();
+
+    // Snapshot of the counters
+    ProductCacheStats getStats() const;
+
+private:
+    struct Entry {
+        ProductKey key;
+        std::shared_ptr<const Matrix> product;
+        size_t bytes;
+    };
+
+    struct SpillFile {
+        ProductKey key;
+        std::string path;
+        size_t bytes;
+    };
+
+    std::string spillPath(const ProductKey& key) const;
+    void dropSpillFile(std::list<SpillFile>::iterator file);
+
+    size_t memoryBudget;
+    size_t diskBudget;
+    std::string spillDir;
+
+    mutable std::mutex cacheMutex;
+    std::list<Entry> lru; // Most recently used first
+    std::unordered_map<ProductKey, std::list<Entry>::iterator, ProductKeyHash> index;
+    std::list<SpillFile> spillLru; // Most recently used first
+    std::unordered_map<ProductKey, std::list<SpillFile>::iterator, ProductKeyHash> spilled;
+    ProductCacheStats stats;
+};
+
+#endif // PRODUCT_CACHE_HPP
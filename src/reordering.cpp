@@ -0,0 +1,695 @@
+#include "reordering.hpp"
+#include "sell_matrix.hpp"
+#include "spgemm.hpp"
+#include "spmv.hpp"
+#include "thread_pool.hpp"
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Columns held by more rows than this do not link rows during clustering
+const int kClusterLinkLimit = 256;
+
+// Breadth-first sweeps spent looking for a pseudo-peripheral start vertex
+const int kPeripheralSweeps = 4;
+
+// Bytes per stored CSR element (value and column index)
+const double kElementBytes = sizeof(double) + sizeof(int);
+
+// Rows of A whose products are counted exactly to estimate the size of A * B
+const int kSampleRows = 1024;
+
+// Rough per-operation costs of the model, measured on one desktop core
+const double kMissSeconds = 100e-9;    // Latency of one random fetch from memory
+const double kSecondsPerByte = 1e-10;  // Streaming at about 10 GB/s
+const double kPermuteSeconds = 25e-9;  // Moving one stored element to its new place
+const double kRcmSeconds = 150e-9;     // Per non-zero of A: symmetrizing and the sweeps
+const double kDegreeSeconds = 50e-9;   // Per non-zero of A
+const double kClusterSeconds = 50e-9;  // Per link between two rows (one heap update)
+const double kModelSeconds = 5e-9;     // Per non-zero of A: one step of a model pass
+
+// Operand-dependent inputs of the cost model
+struct ProductModel {
+    std::vector<double> rowBytes; // Size of every row of B
+    double totalBytes;            // Size of B
+    int rowStreams;               // Separate arrays touched when fetching a row of B
+    double operandSeconds;        // Permuting the rows of B
+    double resultSeconds;         // Permuting the rows of the product back
+};
+
+// Cache modelled per thread: the L2 size when the system reports it
+double modelCacheBytes() {
+    static const double bytes = [] {
+        long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        return size > 0 ? static_cast<double>(size) : 1024.0 * 1024.0;
+    }();
+    return bytes;
+}
+
+// Adjacency lists of the symmetrized pattern of square A, without the diagonal
+// and without duplicates
+void symmetricPattern(const CSRMatrix& A, std::vector<int>& ptr, std::vector<int>& adj) {
+    int n = A.getRows();
+    std::vector<int> count(n + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        for (int p = A.rowPtr[i]; p < A.rowPtr[i + 1]; ++p) {
+            int j = A.colIndices[p];
+            if (j != i) {
+                ++count[i + 1];
+                ++count[j + 1];
+            }
+        }
+    }
+    std::partial_sum(count.begin(), count.end(), count.begin());
+    std::vector<int> fill(count.begin(), count.end() - 1);
+    std::vector<int> raw(count[n]);
+    for (int i = 0; i < n; ++i) {
+        for (int p = A.rowPtr[i]; p < A.rowPtr[i + 1]; ++p) {
+            int j = A.colIndices[p];
+            if (j != i) {
+                raw[fill[i]++] = j;
+                raw[fill[j]++] = i;
+            }
+        }
+    }
+
+    ptr.assign(n + 1, 0);
+    adj.clear();
+    adj.reserve(raw.size());
+    std::vector<int> marker(n, -1);
+    for (int v = 0; v < n; ++v) {
+        for (int p = count[v]; p < count[v + 1]; ++p) {
+            if (marker[raw[p]] != v) {
+                marker[raw[p]] = v;
+                adj.push_back(raw[p]);
+            }
+        }
+        ptr[v + 1] = static_cast<int>(adj.size());
+    }
+}
+
+// Breadth-first levels from root; returns the vertices in visiting order, the
+// number of levels and the start of the last level
+std::vector<int> levelSweep(const std::vector<int>& ptr, const std::vector<int>& adj, int root,
+                            std::vector<int>& mark, int stamp, int& levels, size_t& lastLevel) {
+    std::vector<int> visit(1, root);
+    mark[root] = stamp;
+    size_t levelBegin = 0;
+    levels = 0;
+    lastLevel = 0;
+    while (levelBegin < visit.size()) {
+        ++levels;
+        lastLevel = levelBegin;
+        size_t levelEnd = visit.size();
+        for (size_t q = levelBegin; q < levelEnd; ++q) {
+            int v = visit[q];
+            for (int p = ptr[v]; p < ptr[v + 1]; ++p) {
+                if (mark[adj[p]] != stamp) {
+                    mark[adj[p]] = stamp;
+                    visit.push_back(adj[p]);
+                }
+            }
+        }
+        levelBegin = levelEnd;
+    }
+    return visit;
+}
+
+// Non-zeros of every row of A and of every column of A
+void rowAndColumnCounts(const CSRMatrix& A, std::vector<int>& rowCount, std::vector<int>& colCount) {
+    rowCount.assign(A.getRows(), 0);
+    colCount.assign(A.getCols(), 0);
+    for (int i = 0; i < A.getRows(); ++i) {
+        rowCount[i] = A.rowPtr[i + 1] - A.rowPtr[i];
+        for (int p = A.rowPtr[i]; p < A.rowPtr[i + 1]; ++p) {
+            ++colCount[A.colIndices[p]];
+        }
+    }
+}
+
+// Modelled time spent fetching rows of B when the rows of A are visited in
+// rowOrder. A B row is still cached when fewer than cacheBytes were streamed
+// since its previous use; otherwise it pays one miss per array plus its bytes.
+double modelFetchSeconds(const CSRMatrix& A, const std::vector<int>& rowOrder, const ProductModel& model) {
+    double cacheBytes = modelCacheBytes();
+    std::vector<double> lastUse(A.getCols(), -std::numeric_limits<double>::infinity());
+    double streamed = 0.0;
+    double seconds = 0.0;
+    for (int pos = 0; pos < A.getRows(); ++pos) {
+        int i = rowOrder.empty() ? pos : rowOrder[pos];
+        for (int p = A.rowPtr[i]; p < A.rowPtr[i + 1]; ++p) {
+            int k = A.colIndices[p];
+            double bytes = model.rowBytes[k];
+            if (streamed - lastUse[k] > cacheBytes) {
+                seconds += model.rowStreams * kMissSeconds + bytes * kSecondsPerByte;
+            }
+            streamed += bytes;
+            lastUse[k] = streamed;
+        }
+    }
+    return seconds;
+}
+
+// Modelled cost of computing an ordering of A
+double modelOrderingSeconds(ReorderMethod method, const CSRMatrix& A, const std::vector<int>& colCount) {
+    double nnz = A.getNonZeros();
+    switch (method) {
+    case ReorderMethod::ReverseCuthillMcKee:
+        return kRcmSeconds * nnz;
+    case ReorderMethod::Degree:
+        return kDegreeSeconds * nnz;
+    case ReorderMethod::Cluster: {
+        double links = 0.0;
+        for (int count : colCount) {
+            if (count <= kClusterLinkLimit) {
+                links += static_cast<double>(count) * count;
+            }
+        }
+        return kDegreeSeconds * nnz + kClusterSeconds * links;
+    }
+    default:
+        return 0.0;
+    }
+}
+
+// Check the arguments shared by both planReordering overloads
+void checkPlanArguments(const CSRMatrix& A, ReorderMethod method, int expectedUses) {
+    if (expectedUses < 1) {
+        throw std::invalid_argument("Expected uses must be positive.");
+    }
+    if (A.getRows() != A.getCols() &&
+        (method == ReorderMethod::ReverseCuthillMcKee || method == ReorderMethod::Degree)) {
+        throw std::invalid_argument("Symmetric reordering needs a square matrix.");
+    }
+}
+
+// Model of a B with the given row sizes, leaving the permute costs at zero
+ProductModel rowModel(std::vector<double> rowBytes, int rowStreams) {
+    ProductModel model;
+    model.rowBytes.swap(rowBytes);
+    model.totalBytes = std::accumulate(model.rowBytes.begin(), model.rowBytes.end(), 0.0);
+    model.rowStreams = rowStreams;
+    model.operandSeconds = 0.0;
+    model.resultSeconds = 0.0;
+    return model;
+}
+
+// Plan without a pass over A when B fits in the cache: each row of B is then
+// fetched once whatever the order, so neither Auto nor None can gain anything.
+// Returns false when the full model is needed.
+bool planWithoutModel(const CSRMatrix& A, const ProductModel& model, ReorderMethod method, int expectedUses,
+                      Reordering& plan) {
+    if (method != ReorderMethod::Auto && method != ReorderMethod::None) {
+        return false;
+    }
+    if (model.totalBytes > modelCacheBytes()) {
+        return false;
+    }
+    plan.method = ReorderMethod::None;
+    plan.originalSeconds = model.rowStreams * kMissSeconds * model.rowBytes.size() +
+                           model.totalBytes * kSecondsPerByte;
+    plan.reorderedSeconds = plan.originalSeconds;
+    plan.orderingSeconds = 0.0;
+    plan.planningSeconds = 0.0;
+    plan.permuteSeconds = kPermuteSeconds * A.getNonZeros() + model.operandSeconds;
+    plan.expectedUses = expectedUses;
+    plan.profitable = false;
+    return true;
+}
+
+// Shared part of both planReordering overloads
+Reordering planFor(const CSRMatrix& A, const ProductModel& model, ReorderMethod method, int expectedUses) {
+    bool square = A.getRows() == A.getCols();
+    double passSeconds = kModelSeconds * A.getNonZeros();
+
+    // Operands are permuted once; the product is permuted back after every use
+    Reordering plan;
+    plan.method = ReorderMethod::None;
+    plan.originalSeconds = modelFetchSeconds(A, std::vector<int>(), model);
+    plan.reorderedSeconds = plan.originalSeconds;
+    plan.orderingSeconds = 0.0;
+    plan.planningSeconds = passSeconds;
+    plan.permuteSeconds = kPermuteSeconds * A.getNonZeros() + model.operandSeconds +
+                          model.resultSeconds * expectedUses;
+    plan.expectedUses = expectedUses;
+    plan.profitable = false;
+    if (method == ReorderMethod::None) {
+        return plan;
+    }
+
+    // No order fetches a used row of B less than once
+    std::vector<int> rowCount;
+    std::vector<int> colCount;
+    rowAndColumnCounts(A, rowCount, colCount);
+    plan.planningSeconds += passSeconds;
+    double compulsory = 0.0;
+    for (int k = 0; k < A.getCols(); ++k) {
+        if (colCount[k] > 0) {
+            compulsory += model.rowStreams * kMissSeconds + model.rowBytes[k] * kSecondsPerByte;
+        }
+    }
+    double bestSaving = (plan.originalSeconds - compulsory) * expectedUses;
+
+    std::vector<ReorderMethod> candidates;
+    if (method == ReorderMethod::Auto) {
+        if (square) {
+            candidates.push_back(ReorderMethod::ReverseCuthillMcKee);
+            candidates.push_back(ReorderMethod::Degree);
+        }
+        candidates.push_back(ReorderMethod::Cluster);
+    } else {
+        candidates.push_back(method);
+    }
+
+    // A candidate also has to pay for the model pass that rates it
+    double bestNet = -std::numeric_limits<double>::infinity();
+    double planningSeconds = plan.planningSeconds;
+    for (ReorderMethod candidate : candidates) {
+        double orderingSeconds = modelOrderingSeconds(candidate, A, colCount);
+        if (method == ReorderMethod::Auto && bestSaving <= orderingSeconds + passSeconds + plan.permuteSeconds) {
+            continue;
+        }
+        planningSeconds += passSeconds;
+
+        Reordering trial = plan;
+        trial.method = candidate;
+        trial.orderingSeconds = orderingSeconds;
+        if (candidate == ReorderMethod::ReverseCuthillMcKee) {
+            trial.rowOrder = reverseCuthillMcKeeOrder(A);
+            trial.innerOrder = trial.rowOrder;
+        } else if (candidate == ReorderMethod::Degree) {
+            trial.rowOrder = degreeOrder(A);
+            trial.innerOrder = trial.rowOrder;
+        } else {
+            trial.rowOrder = clusterRowOrder(A);
+            trial.innerOrder = firstUseColumnOrder(A, trial.rowOrder);
+        }
+        trial.reorderedSeconds = modelFetchSeconds(A, trial.rowOrder, model);
+        double saving = (trial.originalSeconds - trial.reorderedSeconds) * expectedUses;
+        trial.profitable = saving > trial.permuteSeconds;
+
+        double net = saving - trial.permuteSeconds - orderingSeconds;
+        if (net > bestNet) {
+            bestNet = net;
+            plan = std::move(trial);
+        }
+    }
+    plan.planningSeconds = planningSeconds;
+    return plan;
+}
+
+// Non-zeros of A * B extrapolated from an exact count over evenly spaced rows
+double estimateProductNonZeros(const CSRMatrix& A, const CSRMatrix& B) {
+    int rows = A.getRows();
+    if (rows == 0) {
+        return 0.0;
+    }
+    int stride = std::max(1, rows / kSampleRows);
+    std::vector<int> marker(B.getCols(), -1);
+    double counted = 0.0;
+    int sampled = 0;
+    for (int i = 0; i < rows; i += stride, ++sampled) {
+        for (int p = A.rowPtr[i]; p < A.rowPtr[i + 1]; ++p) {
+            int k = A.colIndices[p];
+            for (int q = B.rowPtr[k]; q < B.rowPtr[k + 1]; ++q) {
+                if (marker[B.colIndices[q]] != i) {
+                    marker[B.colIndices[q]] = i;
+                    counted += 1.0;
+                }
+            }
+        }
+    }
+    return counted * rows / sampled;
+}
+
+// Modelled cost of gathering rows of a dense matrix into a new order
+double denseRowPermuteSeconds(int rows, int cols) {
+    return rows * (kMissSeconds + 2.0 * sizeof(double) * cols * kSecondsPerByte);
+}
+
+// Copy a row of A into the permuted result, renumbering its columns
+void copyPermutedRow(const CSRMatrix& A, int source, const std::vector<int>& newCol, CSRMatrix& result, int dest) {
+    int begin = A.rowPtr[source];
+    int length = A.rowPtr[source + 1] - begin;
+    int* cols = result.colIndices.data() + result.rowPtr[dest];
+    double* vals = result.values.data() + result.rowPtr[dest];
+    if (newCol.empty()) {
+        std::memcpy(cols, A.colIndices.data() + begin, length * sizeof(int));
+        std::memcpy(vals, A.values.data() + begin, length * sizeof(double));
+        return;
+    }
+    static thread_local std::vector<std::pair<int, double>> entries;
+    entries.clear();
+    for (int p = begin; p < begin + length; ++p) {
+        entries.push_back(std::make_pair(newCol[A.colIndices[p]], A.values[p]));
+    }
+    std::sort(entries.begin(), entries.end());
+    for (int q = 0; q < length; ++q) {
+        cols[q] = entries[q].first;
+        vals[q] = entries[q].second;
+    }
+}
+
+} // namespace
+
+// Report as a single human-readable line
+std::string Reordering::toString() const {
+    std::ostringstream out;
+    out << reorderMethodName(method) << ": modelled B fetches " << originalSeconds << " s -> " << reorderedSeconds
+        << " s, ordering " << orderingSeconds << " s, planning " << planningSeconds << " s, permuting "
+        << permuteSeconds << " s, " << expectedUses
+        << (expectedUses == 1 ? " use" : " uses") << ": "
+        << (profitable ? "applied" : "skipped");
+    return out.str();
+}
+
+// Name of a method
+std::string reorderMethodName(ReorderMethod method) {
+    switch (method) {
+    case ReorderMethod::Auto:
+        return "auto";
+    case ReorderMethod::ReverseCuthillMcKee:
+        return "rcm";
+    case ReorderMethod::Degree:
+        return "degree";
+    case ReorderMethod::Cluster:
+        return "cluster";
+    default:
+        return "none";
+    }
+}
+
+// Reverse Cuthill-McKee ordering of square A
+std::vector<int> reverseCuthillMcKeeOrder(const CSRMatrix& A) {
+    if (A.getRows() != A.getCols()) {
+        throw std::invalid_argument("Symmetric reordering needs a square matrix.");
+    }
+    int n = A.getRows();
+    std::vector<int> ptr;
+    std::vector<int> adj;
+    symmetricPattern(A, ptr, adj);
+    auto degree = [&](int v) { return ptr[v + 1] - ptr[v]; };
+    auto byDegree = [&](int u, int v) { return degree(u) < degree(v); };
+
+    // Components are started from their lowest-degree vertex
+    std::vector<int> starts(n);
+    std::iota(starts.begin(), starts.end(), 0);
+    std::stable_sort(starts.begin(), starts.end(), byDegree);
+
+    std::vector<int> order;
+    order.reserve(n);
+    std::vector<char> placed(n, 0);
+    std::vector<int> mark(n, -1);
+    int stamp = 0;
+    std::vector<int> next;
+    for (int start : starts) {
+        if (placed[start]) {
+            continue;
+        }
+
+        // Move the root to a vertex of high eccentricity (George-Liu)
+        int root = start;
+        int depth = 0;
+        size_t lastLevel = 0;
+        std::vector<int> visit = levelSweep(ptr, adj, root, mark, stamp++, depth, lastLevel);
+        for (int sweep = 0; sweep < kPeripheralSweeps; ++sweep) {
+            int candidate = *std::min_element(visit.begin() + lastLevel, visit.end(), byDegree);
+            int candidateDepth = 0;
+            size_t candidateLast = 0;
+            std::vector<int> candidateVisit =
+                levelSweep(ptr, adj, candidate, mark, stamp++, candidateDepth, candidateLast);
+            if (candidateDepth <= depth) {
+                break;
+            }
+            root = candidate;
+            depth = candidateDepth;
+            lastLevel = candidateLast;
+            visit.swap(candidateVisit);
+        }
+
+        // Cuthill-McKee: breadth-first, unplaced neighbours by increasing degree
+        size_t head = order.size();
+        order.push_back(root);
+        placed[root] = 1;
+        while (head < order.size()) {
+            int v = order[head++];
+            next.clear();
+            for (int p = ptr[v]; p < ptr[v + 1]; ++p) {
+                if (!placed[adj[p]]) {
+                    placed[adj[p]] = 1;
+                    next.push_back(adj[p]);
+                }
+            }
+            std::stable_sort(next.begin(), next.end(), byDegree);
+            order.insert(order.end(), next.begin(), next.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+// Vertices of square A by decreasing degree
+std::vector<int> degreeOrder(const CSRMatrix& A) {
+    if (A.getRows() != A.getCols()) {
+        throw std::invalid_argument("Symmetric reordering needs a square matrix.");
+    }
+    std::vector<int> rowCount;
+    std::vector<int> colCount;
+    rowAndColumnCounts(A, rowCount, colCount);
+    std::vector<int> order(A.getRows());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int u, int v) {
+        return rowCount[u] + colCount[u] > rowCount[v] + colCount[v];
+    });
+    return order;
+}
+
+// Greedy clustering of rows that share columns
+std::vector<int> clusterRowOrder(const CSRMatrix& A, int clusterSize) {
+    if (clusterSize < 1) {
+        throw std::invalid_argument("Cluster size must be positive.");
+    }
+    int rows = A.getRows();
+
+    // Rows of every column (transposed pattern)
+    std::vector<int> colPtr(A.getCols() + 1, 0);
+    for (int p = 0; p < A.getNonZeros(); ++p) {
+        ++colPtr[A.colIndices[p] + 1];
+    }
+    std::partial_sum(colPtr.begin(), colPtr.end(), colPtr.begin());
+    std::vector<int> fill(colPtr.begin(), colPtr.end() - 1);
+    std::vector<int> colRows(A.getNonZeros());
+    for (int i = 0; i < rows; ++i) {
+        for (int p = A.rowPtr[i]; p < A.rowPtr[i + 1]; ++p) {
+            colRows[fill[A.colIndices[p]]++] = i;
+        }
+    }
+
+    std::vector<int> order;
+    order.reserve(rows);
+    std::vector<char> placed(rows, 0);
+    std::vector<int> score(rows, 0);
+    std::vector<int> touched;
+    std::priority_queue<std::pair<int, int>> heap; // (score, -row), stale entries skipped
+
+    auto place = [&](int r) {
+        placed[r] = 1;
+        order.push_back(r);
+        for (int p = A.rowPtr[r]; p < A.rowPtr[r + 1]; ++p) {
+            int c = A.colIndices[p];
+            if (colPtr[c + 1] - colPtr[c] > kClusterLinkLimit) {
+                continue;
+            }
+            for (int q = colPtr[c]; q < colPtr[c + 1]; ++q) {
+                int other = colRows[q];
+                if (placed[other]) {
+                    continue;
+                }
+                if (score[other]++ == 0) {
+                    touched.push_back(other);
+                }
+                heap.push(std::make_pair(score[other], -other));
+            }
+        }
+    };
+
+    for (int seed = 0; seed < rows; ++seed) {
+        if (placed[seed]) {
+            continue;
+        }
+        place(seed);
+        for (int members = 1; members < clusterSize && !heap.empty();) {
+            std::pair<int, int> top = heap.top();
+            heap.pop();
+            int r = -top.second;
+            if (placed[r] || top.first != score[r]) {
+                continue;
+            }
+            place(r);
+            ++members;
+        }
+        for (int r : touched) {
+            score[r] = 0;
+        }
+        touched.clear();
+        heap = std::priority_queue<std::pair<int, int>>();
+    }
+    return order;
+}
+
+// Columns of A in order of first use
+std::vector<int> firstUseColumnOrder(const CSRMatrix& A, const std::vector<int>& rowOrder) {
+    std::vector<char> used(A.getCols(), 0);
+    std::vector<int> order;
+    order.reserve(A.getCols());
+    for (int pos = 0; pos < A.getRows(); ++pos) {
+        int i = rowOrder.empty() ? pos : rowOrder[pos];
+        for (int p = A.rowPtr[i]; p < A.rowPtr[i + 1]; ++p) {
+            if (!used[A.colIndices[p]]) {
+                used[A.colIndices[p]] = 1;
+                order.push_back(A.colIndices[p]);
+            }
+        }
+    }
+    for (int k = 0; k < A.getCols(); ++k) {
+        if (!used[k]) {
+            order.push_back(k);
+        }
+    }
+    return order;
+}
+
+// Inverse of an ordering
+std::vector<int> inverseOrder(const std::vector<int>& order) {
+    int n = static_cast<int>(order.size());
+    std::vector<int> inverse(n, -1);
+    for (int i = 0; i < n; ++i) {
+        if (order[i] < 0 || order[i] >= n || inverse[order[i]] != -1) {
+            throw std::invalid_argument("Ordering is not a permutation.");
+        }
+        inverse[order[i]] = i;
+    }
+    return inverse;
+}
+
+// Permute the rows and columns of a CSR matrix
+CSRMatrix permuteCSR(const CSRMatrix& A, const std::vector<int>& rowOrder, const std::vector<int>& colOrder) {
+    int rows = A.getRows();
+    if ((!rowOrder.empty() && static_cast<int>(rowOrder.size()) != rows) ||
+        (!colOrder.empty() && static_cast<int>(colOrder.size()) != A.getCols())) {
+        throw std::invalid_argument("Ordering size does not match the matrix.");
+    }
+    if (!rowOrder.empty()) {
+        inverseOrder(rowOrder);
+    }
+    std::vector<int> newCol = colOrder.empty() ? std::vector<int>() : inverseOrder(colOrder);
+
+    CSRMatrix result(rows, A.getCols());
+    for (int i = 0; i < rows; ++i) {
+        int source = rowOrder.empty() ? i : rowOrder[i];
+        result.rowPtr[i + 1] = result.rowPtr[i] + A.rowPtr[source + 1] - A.rowPtr[source];
+    }
+    result.colIndices.resize(A.getNonZeros());
+    result.values.resize(A.getNonZeros());
+    sharedThreadPool().parallelFor(0, rows, 1024, [&](int lo, int hi) {
+        for (int i = lo; i < hi; ++i) {
+            copyPermutedRow(A, rowOrder.empty() ? i : rowOrder[i], newCol, result, i);
+        }
+    });
+    return result;
+}
+
+// Permute the rows of a dense matrix
+Matrix permuteRows(const Matrix& X, const std::vector<int>& order) {
+    if (static_cast<int>(order.size()) != X.getRows()) {
+        throw std::invalid_argument("Ordering size does not match the matrix.");
+    }
+    inverseOrder(order);
+    Matrix result(X.getRows(), X.getCols());
+    sharedThreadPool().parallelFor(0, X.getRows(), 256, [&](int lo, int hi) {
+        for (int i = lo; i < hi; ++i) {
+            std::memcpy(result.rowData(i), X.rowData(order[i]), X.getCols() * sizeof(double));
+        }
+    });
+    return result;
+}
+
+// Plan for CSR SpGEMM: a row of B spans rowPtr, colIndices and values
+Reordering planReordering(const CSRMatrix& A, const CSRMatrix& B, ReorderMethod method, int expectedUses) {
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+    checkPlanArguments(A, method, expectedUses);
+    std::vector<double> rowBytes(B.getRows());
+    for (int k = 0; k < B.getRows(); ++k) {
+        rowBytes[k] = kElementBytes * (B.rowPtr[k + 1] - B.rowPtr[k]);
+    }
+    ProductModel model = rowModel(std::move(rowBytes), 3);
+    model.operandSeconds = kPermuteSeconds * B.getNonZeros();
+    Reordering plan;
+    if (planWithoutModel(A, model, method, expectedUses, plan)) {
+        return plan;
+    }
+    model.resultSeconds = kPermuteSeconds * estimateProductNonZeros(A, B);
+    return planFor(A, model, method, expectedUses);
+}
+
+// Plan for SpMM with a dense right-hand side
+Reordering planReordering(const CSRMatrix& A, const Matrix& X, ReorderMethod method, int expectedUses) {
+    if (A.getCols() != X.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+    checkPlanArguments(A, method, expectedUses);
+    ProductModel model = rowModel(std::vector<double>(X.getRows(), sizeof(double) * static_cast<double>(X.getCols())), 1);
+    model.operandSeconds = denseRowPermuteSeconds(X.getRows(), X.getCols());
+    Reordering plan;
+    if (planWithoutModel(A, model, method, expectedUses, plan)) {
+        return plan;
+    }
+    model.resultSeconds = denseRowPermuteSeconds(A.getRows(), X.getCols());
+    return planFor(A, model, method, expectedUses);
+}
+
+// CSR SpGEMM on reordered operands
+CSRMatrix sparseSparseMultiplyReordered(const CSRMatrix& A, const CSRMatrix& B, ReorderMethod method,
+                                        Reordering* plan) {
+    Reordering chosen = planReordering(A, B, method);
+    CSRMatrix result(0, 0);
+    if (!chosen.profitable) {
+        result = sparseSparseMultiplyCSR(A, B);
+    } else {
+        CSRMatrix permuted = sparseSparseMultiplyCSR(permuteCSR(A, chosen.rowOrder, chosen.innerOrder),
+                                                     permuteCSR(B, chosen.innerOrder, std::vector<int>()));
+        result = permuteCSR(permuted, inverseOrder(chosen.rowOrder), std::vector<int>());
+    }
+    if (plan != nullptr) {
+        *plan = std::move(chosen);
+    }
+    return result;
+}
+
+// SELL-C-sigma SpMM on reordered operands
+Matrix sellSpMMReordered(const CSRMatrix& A, const Matrix& X, ReorderMethod method, Reordering* plan) {
+    Reordering chosen = planReordering(A, X, method);
+    Matrix result(0, 0);
+    if (!chosen.profitable) {
+        result = sellSpMM(SellCSigmaMatrix(A), X);
+    } else {
+        Matrix permuted = sellSpMM(SellCSigmaMatrix(permuteCSR(A, chosen.rowOrder, chosen.innerOrder)),
+                                   permuteRows(X, chosen.innerOrder));
+        result = permuteRows(permuted, inverseOrder(chosen.rowOrder));
+    }
+    if (plan != nullptr) {
+        *plan = std::move(chosen);
+    }
+    return result;
+}
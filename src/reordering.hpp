@@ -0,0 +1,94 @@
+#ifndef REORDERING_HPP
+#define REORDERING_HPP
+
+#include "csr_matrix.hpp"
+#include "matrix.hpp"
+#include <string>
+#include <vector>
+
+// Orderings are stored as order[newIndex] = oldIndex. An empty order stands
+// for the identity.
+
+// Ordering applied to the operands of a sparse product
+enum class ReorderMethod {
+    Auto,                // Model every applicable method and keep the best, if it pays off
+    None,                // Keep the original order
+    ReverseCuthillMcKee, // Symmetric bandwidth reduction (square A only)
+    Degree,              // Symmetric, vertices by decreasing degree so hubs share lines (square A only)
+    Cluster              // Rows grouped by shared columns, inner index by first use
+};
+
+// Reordering of C = A * B (or A * X) with its modelled cost and benefit.
+// Times come from rough per-element costs: a row of B is fetched from memory
+// (one miss per array it spans, plus its bytes) unless it was used within the
+// last cache-sized stretch of accesses, and permuting moves every stored
+// element of A, of B and of the product once.
+struct Reordering {
+    ReorderMethod method;
+    std::vector<int> rowOrder;    // Rows of A and of the product
+    std::vector<int> innerOrder;  // Columns of A and rows of B
+    double originalSeconds;       // Modelled B fetch time in the original order
+    double reorderedSeconds;      // Modelled B fetch time after reordering
+    double orderingSeconds;       // Modelled cost of computing the ordering (already spent)
+    double planningSeconds;       // Modelled cost of the model's own passes over A (already spent)
+    double permuteSeconds;        // Modelled cost of permuting operands and results
+    int expectedUses;             // Multiplies the permuted operands are expected to serve
+    bool profitable;              // (original - reordered) * uses exceeds permuteSeconds
+
+    // Report as a single human-readable line
+    std::string toString() const;
+};
+
+// Name of a method, e.g. "rcm"
+std::string reorderMethodName(ReorderMethod method);
+
+// Reverse Cuthill-McKee on the symmetrized pattern of square A: breadth-first
+// from a pseudo-peripheral vertex of each component, neighbours by
+// increasing degree, then reversed
+std::vector<int> reverseCuthillMcKeeOrder(const CSRMatrix& A);
+
+// Vertices of square A by decreasing degree (row plus column non-zeros)
+std::vector<int> degreeOrder(const CSRMatrix& A);
+
+// Greedy row clustering: each cluster starts at the first unplaced row and
+// repeatedly takes the unplaced row sharing the most columns with it, up to
+// clusterSize rows. Columns held by very many rows are ignored as links.
+std::vector<int> clusterRowOrder(const CSRMatrix& A, int clusterSize = 64);
+
+// Columns of A in order of first use when its rows are visited in rowOrder
+// (unused columns last)
+std::vector<int> firstUseColumnOrder(const CSRMatrix& A, const std::vector<int>& rowOrder);
+
+// Inverse of an ordering
+std::vector<int> inverseOrder(const std::vector<int>& order);
+
+// Row i of the result is row rowOrder[i] of A; column j is column colOrder[j]
+CSRMatrix permuteCSR(const CSRMatrix& A, const std::vector<int>& rowOrder, const std::vector<int>& colOrder);
+
+// Row i of the result is row order[i] of X
+Matrix permuteRows(const Matrix& X, const std::vector<int>& order);
+
+// Choose a reordering for A * B (CSR SpGEMM) or A * X (SpMM with a dense X).
+// With Auto or None, a B that fits in the modelled cache ends planning after
+// one pass over the rows of B: every row is then fetched once in any order.
+// Otherwise methods whose best possible saving cannot pay for themselves,
+// including the model pass that would rate them, are not computed at all;
+// with expectedUses > 1 the permuted operands are assumed to be reused and
+// the saving counts once per use.
+Reordering planReordering(const CSRMatrix& A, const CSRMatrix& B,
+                          ReorderMethod method = ReorderMethod::Auto, int expectedUses = 1);
+Reordering planReordering(const CSRMatrix& A, const Matrix& X,
+                          ReorderMethod method = ReorderMethod::Auto, int expectedUses = 1);
+
+// CSR SpGEMM on reordered operands, with the result permuted back to the
+// original row order. The reordering is skipped unless the plan is
+// profitable; the plan is returned through plan when given.
+CSRMatrix sparseSparseMultiplyReordered(const CSRMatrix& A, const CSRMatrix& B,
+                                        ReorderMethod method = ReorderMethod::Auto,
+                                        Reordering* plan = nullptr);
+
+// SELL-C-sigma SpMM on reordered operands, likewise
+Matrix sellSpMMReordered(const CSRMatrix& A, const Matrix& X,
+                         ReorderMethod method = ReorderMethod::Auto, Reordering* plan = nullptr);
+
+#endif // REORDERING_HPP
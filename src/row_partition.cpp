@@ -0,0 +1,84 @@
+#include "row_partition.hpp"
+#include <algorithm>
+
+// Constructor: greedy cut of the prefix sum at multiples of the target
+RowPartition::RowPartition(const std::vector<long long>& rowWork, int numParts, double heavyFactor)
+    : rowWork(rowWork) {
+    int rows = static_cast<int>(rowWork.size());
+    long long total = 0;
+    for (long long w : rowWork) {
+        total += w;
+    }
+    numParts = std::max(1, numParts);
+    long long target = std::max(1LL, (total + numParts - 1) / numParts);
+    double heavy = std::max(1.0, heavyFactor) * static_cast<double>(target);
+
+    int begin = 0;
+    long long accumulated = 0;
+    for (int i = 0; i < rows; ++i) {
+        if (static_cast<double>(rowWork[i]) > heavy) {
+            if (i > begin) {
+                parts.push_back(RowPart{begin, i, 0, 0, -1});
+            }
+            long long pieces = (rowWork[i] + target - 1) / target;
+            for (long long q = 0; q < pieces; ++q) {
+                RowPart piece{i, i + 1, rowWork[i] * q / pieces, rowWork[i] * (q + 1) / pieces,
+                              static_cast<int>(pieceBuffers.size())};
+                parts.push_back(piece);
+                pieceBuffers.push_back(std::vector<double>());
+            }
+            begin = i + 1;
+            accumulated = 0;
+            continue;
+        }
+        accumulated += rowWork[i];
+        if (accumulated >= target) {
+            parts.push_back(RowPart{begin, i + 1, 0, 0, -1});
+            begin = i + 1;
+            accumulated = 0;
+        }
+    }
+    if (begin < rows) {
+        parts.push_back(RowPart{begin, rows, 0, 0, -1});
+    }
+}
+
+// Get number of parts
+int RowPartition::getPartCount() const {
+    return static_cast<int>(parts.size());
+}
+
+// Get part p
+const RowPart& RowPartition::getPart(int p) const {
+    return parts[p];
+}
+
+// Run part p: whole rows write straight into result, a piece into its buffer
+void RowPartition::runPart(int p, Matrix& result, const RowKernel& kernel) {
+    const RowPart& part = parts[p];
+    if (part.isPiece()) {
+        std::vector<double>& buffer = pieceBuffers[part.pieceIndex];
+        buffer.assign(result.getCols(), 0.0);
+        kernel(part.beginRow, part.beginUnit, part.endUnit, buffer.data());
+        return;
+    }
+    for (int row = part.beginRow; row < part.endRow; ++row) {
+        if (rowWork[row] > 0) {
+            kernel(row, 0, rowWork[row], result.rowData(row));
+        }
+    }
+}
+
+// Merge step: add every piece buffer into its row
+void RowPartition::merge(Matrix& result) {
+    for (const RowPart& part : parts) {
+        if (!part.isPiece()) {
+            continue;
+        }
+        const std::vector<double>& buffer = pieceBuffers[part.pieceIndex];
+        double* row = result.rowData(part.beginRow);
+        for (size_t j = 0; j < buffer.size(); ++j) {
+            row[j] += buffer[j];
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef ROW_PARTITION_HPP
+#define ROW_PARTITION_HPP
+
+#include "matrix.hpp"
+#include <functional>
+#include <vector>
+
+// One unit of scheduled work: a range of whole rows, or a piece of a single
+// heavy row covering its work units [beginUnit, endUnit)
+struct RowPart {
+    int beginRow;
+    int endRow;         // Exclusive
+    long long beginUnit; // Only meaningful for pieces
+    long long endUnit;
+    int pieceIndex;     // Buffer of the piece, or -1 for whole rows
+
+    bool isPiece() const { return pieceIndex >= 0; }
+};
+
+// Adds the contribution of work units [beginUnit, endUnit) of row to out
+// (a row of the result or a piece buffer, both zero-initialized). A unit is
+// whatever the caller counted per row: a non-zero element, a flop, ...
+typedef std::function<void(int row, long long beginUnit, long long endUnit, double* out)> RowKernel;
+
+// Work-balanced split of the rows of a product. Rows are cut into ranges of
+// roughly equal total work using the prefix sum of rowWork, and a row whose
+// work exceeds heavyFactor times the per-part target is cut into pieces of
+// its own. Pieces accumulate into private buffers that merge() adds back, so
+// pieces of the same row can run at the same time.
+class RowPartition {
+public:
+    // Constructor: split rowWork into about `parts` ranges
+    RowPartition(const std::vector<long long>& rowWork, int parts, double heavyFactor = 1.0);
+
+    // Get number of parts (pieces of heavy rows included)
+    int getPartCount() const;
+
+    // Get part p
+    const RowPart& getPart(int p) const;
+
+    // Run part p (parts may run concurrently)
+    void runPart(int p, Matrix& result, const RowKernel& kernel);
+
+    // Add the piece buffers into their rows, once every part has run
+    void merge(Matrix& result);
+
+private:
+    std::vector<long long> rowWork;
+    std::vector<RowPart> parts;
+    std::vector<std::vector<double>> pieceBuffers;
+};
+
+#endif // ROW_PARTITION_HPP
@@ -0,0 +1,90 @@
+#include "sell_matrix.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+// Build from CSR
+SellCSigmaMatrix::SellCSigmaMatrix(const CSRMatrix& csr, int chunkHeight, int sigma)
+    : rows(csr.getRows()), cols(csr.getCols()), chunkHeight(chunkHeight) {
+    if (chunkHeight != 4 && chunkHeight != 8 && chunkHeight != 16) {
+        throw std::invalid_argument("SELL chunk height must be 4, 8 or 16.");
+    }
+    if (sigma < 1) {
+        sigma = 1;
+    }
+
+    int numChunks = (rows + chunkHeight - 1) / chunkHeight;
+    rowPerm.assign(numChunks * chunkHeight, -1);
+
+    // Sort rows by decreasing length inside each sigma window
+    for (int start = 0; start < rows; start += sigma) {
+        int end = std::min(start + sigma, rows);
+        for (int i = start; i < end; ++i) {
+            rowPerm[i] = i;
+        }
+        std::stable_sort(rowPerm.begin() + start, rowPerm.begin() + end, [&csr](int a, int b) {
+            return csr.rowPtr[a + 1] - csr.rowPtr[a] > csr.rowPtr[b + 1] - csr.rowPtr[b];
+        });
+    }
+
+    // Pad every chunk to its longest row
+    chunkPtr.assign(numChunks + 1, 0);
+    chunkLength.assign(numChunks, 0);
+    for (int c = 0; c < numChunks; ++c) {
+        int length = 0;
+        for (int r = 0; r < chunkHeight; ++r) {
+            int row = rowPerm[c * chunkHeight + r];
+            if (row >= 0) {
+                length = std::max(length, csr.rowPtr[row + 1] - csr.rowPtr[row]);
+            }
+        }
+        chunkLength[c] = length;
+        chunkPtr[c + 1] = chunkPtr[c] + length * chunkHeight;
+    }
+
+    // Store each chunk column-major. Padding repeats the row's last column so
+    // the gather stays on a cache line that is already being loaded.
+    colIndices.assign(chunkPtr[numChunks], 0);
+    values.assign(chunkPtr[numChunks], 0.0);
+    for (int c = 0; c < numChunks; ++c) {
+        for (int r = 0; r < chunkHeight; ++r) {
+            int row = rowPerm[c * chunkHeight + r];
+            int begin = row >= 0 ? csr.rowPtr[row] : 0;
+            int length = row >= 0 ? csr.rowPtr[row + 1] - begin : 0;
+            int padCol = length > 0 ? csr.colIndices[begin + length - 1] : 0;
+            for (int j = 0; j < chunkLength[c]; ++j) {
+                int pos = chunkPtr[c] + j * chunkHeight + r;
+                if (j < length) {
+                    colIndices[pos] = csr.colIndices[begin + j];
+                    values[pos] = csr.values[begin + j];
+                } else {
+                    colIndices[pos] = padCol;
+                }
+            }
+        }
+    }
+}
+
+// Get number of rows
+int SellCSigmaMatrix::getRows() const {
+    return rows;
+}
+
+// Get number of columns
+int SellCSigmaMatrix::getCols() const {
+    return cols;
+}
+
+// Get rows per chunk
+int SellCSigmaMatrix::getChunkHeight() const {
+    return chunkHeight;
+}
+
+// Get number of chunks
+int SellCSigmaMatrix::getChunkCount() const {
+    return static_cast<int>(chunkLength.size());
+}
+
+// Get number of stored elements including padding
+int SellCSigmaMatrix::getStoredElements() const {
+    return chunkPtr.back();
+}
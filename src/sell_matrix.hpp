@@ -0,0 +1,44 @@
+#ifndef SELL_MATRIX_HPP
+#define SELL_MATRIX_HPP
+
+#include "csr_matrix.hpp"
+#include <vector>
+
+// Sliced ELLPACK (SELL-C-sigma) sparse matrix.
+// Rows are sorted by length inside windows of sigma rows, then grouped into
+// chunks of chunkHeight rows. Each chunk is padded to its longest row and
+// stored column-major, so one SIMD load picks up the j-th element of
+// chunkHeight consecutive rows even when the rows themselves are short.
+class SellCSigmaMatrix {
+public:
+    // Build from CSR (chunkHeight is 4, 8 or 16: one to four AVX2 registers per chunk)
+    explicit SellCSigmaMatrix(const CSRMatrix& csr, int chunkHeight = 8, int sigma = 256);
+
+    // Get number of rows
+    int getRows() const;
+
+    // Get number of columns
+    int getCols() const;
+
+    // Get rows per chunk
+    int getChunkHeight() const;
+
+    // Get number of chunks
+    int getChunkCount() const;
+
+    // Get number of stored elements including padding
+    int getStoredElements() const;
+
+    std::vector<int> chunkPtr;    // chunks + 1 offsets into colIndices/values
+    std::vector<int> chunkLength; // Padded row length of each chunk
+    std::vector<int> rowPerm;     // Original row of each sorted row slot (-1 for padding rows)
+    std::vector<int> colIndices;  // Column of each element, column-major inside a chunk
+    std::vector<double> values;   // Value of each element (0.0 for padding)
+
+private:
+    int rows;
+    int cols;
+    int chunkHeight;
+};
+
+#endif // SELL_MATRIX_HPP
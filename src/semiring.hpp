@@ -0,0 +1,58 @@
+#ifndef SEMIRING_HPP
+#define SEMIRING_HPP
+
+#include <immintrin.h> // For AVX
+#include <limits>
+
+// Semiring policies for the templated engines (simd_semiring_gemm_block,
+// cache_optimized_semiring_multiply, combinedSemiringMultiply and
+// sparseSemiringMultiplyCSR). A policy supplies scalar and AVX2 versions of
+// add and mul, a fused mulAdd(a, b, c) = c add (a mul b), and the identities:
+// zero() for add, which is also what missing elements of a sparse operand and
+// empty tiles stand for, and one() for mul.
+//
+// The engines are explicitly instantiated for the four policies below; a new
+// semiring needs its instantiations added next to theirs.
+
+// Ordinary (+, x) arithmetic
+struct PlusTimes {
+    static double zero() { return 0.0; }
+    static double one() { return 1.0; }
+    static double add(double a, double b) { return a + b; }
+    static double mul(double a, double b) { return a * b; }
+    static __m256d add(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+    static __m256d mulAdd(__m256d a, __m256d b, __m256d c) { return _mm256_fmadd_pd(a, b, c); }
+};
+
+// Tropical (min, +): shortest paths, with +inf for "no edge"
+struct MinPlus {
+    static double zero() { return std::numeric_limits<double>::infinity(); }
+    static double one() { return 0.0; }
+    static double add(double a, double b) { return b < a ? b : a; }
+    static double mul(double a, double b) { return a + b; }
+    static __m256d add(__m256d a, __m256d b) { return _mm256_min_pd(a, b); }
+    static __m256d mulAdd(__m256d a, __m256d b, __m256d c) { return _mm256_min_pd(c, _mm256_add_pd(a, b)); }
+};
+
+// (max, +): longest paths and Viterbi on log-probabilities, with -inf for "no edge"
+struct MaxPlus {
+    static double zero() { return -std::numeric_limits<double>::infinity(); }
+    static double one() { return 0.0; }
+    static double add(double a, double b) { return b > a ? b : a; }
+    static double mul(double a, double b) { return a + b; }
+    static __m256d add(__m256d a, __m256d b) { return _mm256_max_pd(a, b); }
+    static __m256d mulAdd(__m256d a, __m256d b, __m256d c) { return _mm256_max_pd(c, _mm256_add_pd(a, b)); }
+};
+
+// (max, x): Viterbi on probabilities. Only a semiring for non-negative
+// values, which is what makes 0 its zero.
+struct MaxTimes {
+    static double zero() { return 0.0; }
+    static double one() { return 1.0; }
+    static double add(double a, double b) { return b > a ? b : a; }
+    static double mul(double a, double b) { return a * b; }
+    static __m256d add(__m256d a, __m256d b) { return _mm256_max_pd(a, b); }
+    static __m256d mulAdd(__m256d a, __m256d b, __m256d c) { return _mm256_max_pd(c, _mm256_mul_pd(a, b)); }
+};
+
+#endif // SEMIRING_HPP
@@ -2,7 +2,7 @@
 #include <immintrin.h> // For AVX
 
 // Function to multiply a single row of A with B using AVX for dense-dense multiplication
-void simd_multiplyRowDenseDense(const Matrix& A, const Matrix& B, Matrix& result, int row) {
+void simd_multiplyRowDenseDense(const MatrixView& A, const MatrixView& B, Matrix& result, int row) {
     for (int col = 0; col < B.getCols(); ++col) {
         __m256d sum = _mm256_setzero_pd(); // Initialize sum to zero
 
@@ -38,20 +38,40 @@ void simd_multiplyRowDenseDense(const Matrix& A, const Matrix& B, Matrix& result
 }
 
 // Dense-Dense multiplication using AVX
-Matrix simd_dense_dense_multiply(const Matrix& A, const Matrix& B) {
+Matrix simd_dense_dense_multiply(const MatrixView& A, const MatrixView& B) {
+    return simd_dense_dense_multiply_with_epilogue(A, B, Epilogue());
+}
+
+// Dense-Dense multiplication using AVX with a fused epilogue
+Matrix simd_dense_dense_multiply_with_epilogue(const MatrixView& A, const MatrixView& B,
+                                               const Epilogue& epilogue) {
     int rows = A.getRows();
     int cols = B.getCols();
     Matrix result(rows, cols);
+    epilogue.prepare(rows, cols);
 
     for (int i = 0; i < rows; ++i) {
         simd_multiplyRowDenseDense(A, B, result, i);
+        if (!epilogue.empty()) {
+            epilogue.apply(i, 0, 1, cols, result.rowData(i), cols); // Row is still in L1
+        }
     }
 
     return result;
 }
 
+// Dense-Dense multiplication with a prepacked B
+Matrix simd_dense_dense_multiply_packed(const MatrixView& A, const PackedMatrix& B) {
+    return packedMultiply(A, B, false);
+}
+
+// Dense-Dense multiplication with a prepacked A
+Matrix simd_dense_dense_multiply_packed(const PackedMatrix& A, const MatrixView& B) {
+    return packedMultiply(A, B, false);
+}
+
 // Function to multiply a single row of A with B using AVX for dense-sparse multiplication
-void simd_multiplyRowDenseSparse(const Matrix& A, const Matrix& B, Matrix& result, int row) {
+void simd_multiplyRowDenseSparse(const MatrixView& A, const MatrixView& B, Matrix& result, int row) {
     for (int col = 0; col < B.getCols(); ++col) {
         __m256d sum = _mm256_setzero_pd(); // Initialize sum to zero
 
@@ -87,7 +107,7 @@ void simd_multiplyRowDenseSparse(const Matrix& A, const Matrix& B, Matrix& resul
 }
 
 // Dense-Sparse multiplication using AVX
-Matrix simd_dense_sparse_multiply(const Matrix& A, const Matrix& B) {
+Matrix simd_dense_sparse_multiply(const MatrixView& A, const MatrixView& B) {
     int rows = A.getRows();
     int cols = B.getCols();
     Matrix result(rows, cols);
@@ -100,7 +120,7 @@ Matrix simd_dense_sparse_multiply(const Matrix& A, const Matrix& B) {
 }
 
 // Function to multiply a single row of A with B using AVX for sparse-sparse multiplication
-void simd_multiplyRowSparseSparse(const Matrix& A, const Matrix& B, Matrix& result, int row) {
+void simd_multiplyRowSparseSparse(const MatrixView& A, const MatrixView& B, Matrix& result, int row) {
     for (int col = 0; col < B.getCols(); ++col) {
         __m256d sum = _mm256_setzero_pd(); // Initialize sum to zero
 
@@ -136,7 +156,7 @@ void simd_multiplyRowSparseSparse(const Matrix& A, const Matrix& B, Matrix& resu
 }
 
 // Sparse-Sparse multiplication using AVX
-Matrix simd_sparse_sparse_multiply(const Matrix& A, const Matrix& B) {
+Matrix simd_sparse_sparse_multiply(const MatrixView& A, const MatrixView& B) {
     int rows = A.getRows();
     int cols = B.getCols();
     Matrix result(rows, cols);
@@ -147,3 +167,230 @@ Matrix simd_sparse_sparse_multiply(const Matrix& A, const Matrix& B) {
 
     return result;
 }
+
+// Mask selecting the first n (1 to 4) lanes of a 256-bit register
+static inline __m256i simd_lane_mask(int n) {
+    return _mm256_cmpgt_epi64(_mm256_set1_epi64x(n), _mm256_set_epi64x(3, 2, 1, 0));
+}
+
+// MR x 8 tile of C kept in registers across the whole k loop
+template <class S, int MR>
+static inline void simd_tile_8(int k, const double* A, int lda, const double* B, int ldb,
+                               double* C, int ldc) {
+    __m256d c0[MR], c1[MR];
+    for (int r = 0; r < MR; ++r) {
+        c0[r] = _mm256_loadu_pd(C + r * ldc);
+        c1[r] = _mm256_loadu_pd(C + r * ldc + 4);
+    }
+    for (int p = 0; p < k; ++p, B += ldb) {
+        __m256d b0 = _mm256_loadu_pd(B);
+        __m256d b1 = _mm256_loadu_pd(B + 4);
+        for (int r = 0; r < MR; ++r) {
+            __m256d a = _mm256_broadcast_sd(A + r * lda + p);
+            c0[r] = S::mulAdd(a, b0, c0[r]);
+            c1[r] = S::mulAdd(a, b1, c1[r]);
+        }
+    }
+    for (int r = 0; r < MR; ++r) {
+        _mm256_storeu_pd(C + r * ldc, c0[r]);
+        _mm256_storeu_pd(C + r * ldc + 4, c1[r]);
+    }
+}
+
+// MR x n tile of C (n from 1 to 4) using masked loads and stores
+template <class S, int MR>
+static inline void simd_tile_masked(int n, int k, const double* A, int lda, const double* B, int ldb,
+                                    double* C, int ldc) {
+    __m256i mask = simd_lane_mask(n);
+    __m256d c[MR];
+    for (int r = 0; r < MR; ++r) {
+        c[r] = _mm256_maskload_pd(C + r * ldc, mask);
+    }
+    for (int p = 0; p < k; ++p, B += ldb) {
+        __m256d b = _mm256_maskload_pd(B, mask);
+        for (int r = 0; r < MR; ++r) {
+            c[r] = S::mulAdd(_mm256_broadcast_sd(A + r * lda + p), b, c[r]);
+        }
+    }
+    for (int r = 0; r < MR; ++r) {
+        _mm256_maskstore_pd(C + r * ldc, mask, c[r]);
+    }
+}
+
+// All column tiles for a strip of MR rows
+template <class S, int MR>
+static void simd_row_strip(int n, int k, const double* A, int lda, const double* B, int ldb,
+                           double* C, int ldc) {
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        simd_tile_8<S, MR>(k, A, lda, B + j, ldb, C + j, ldc);
+    }
+    for (; j < n; j += 4) {
+        int width = n - j < 4 ? n - j : 4;
+        simd_tile_masked<S, MR>(width, k, A, lda, B + j, ldb, C + j, ldc);
+    }
+}
+
+// Register-blocked AVX2 kernel over a semiring: C[m x n] = C add (A mul B)
+template <class S>
+void simd_semiring_gemm_block(int m, int n, int k, const double* A, int lda,
+                              const double* B, int ldb, double* C, int ldc) {
+    int i = 0;
+    for (; i + 4 <= m; i += 4, A += 4 * lda, C += 4 * ldc) {
+        simd_row_strip<S, 4>(n, k, A, lda, B, ldb, C, ldc);
+    }
+    switch (m - i) {
+    case 3:
+        simd_row_strip<S, 3>(n, k, A, lda, B, ldb, C, ldc);
+        break;
+    case 2:
+        simd_row_strip<S, 2>(n, k, A, lda, B, ldb, C, ldc);
+        break;
+    case 1:
+        simd_row_strip<S, 1>(n, k, A, lda, B, ldb, C, ldc);
+        break;
+    default:
+        break;
+    }
+}
+
+// Register-blocked AVX2 kernel: C[m x n] += A[m x k] * B[k x n]
+void simd_gemm_block(int m, int n, int k, const double* A, int lda,
+                     const double* B, int ldb, double* C, int ldc) {
+    simd_semiring_gemm_block<PlusTimes>(m, n, k, A, lda, B, ldb, C, ldc);
+}
+
+// MR x n tile of C (n from 1 to 8) from rows of A and a packed B panel holding
+// 8 values per k step
+template <int MR>
+static inline void simd_tile_packed_b(int n, int k, const double* A, int lda, const double* panel,
+                                      double* C, int ldc) {
+    __m256i mask0 = simd_lane_mask(n < 4 ? n : 4);
+    __m256i mask1 = simd_lane_mask(n > 4 ? n - 4 : 0);
+    __m256d c0[MR], c1[MR];
+    for (int r = 0; r < MR; ++r) {
+        c0[r] = _mm256_maskload_pd(C + r * ldc, mask0);
+        c1[r] = _mm256_maskload_pd(C + r * ldc + 4, mask1);
+    }
+    for (int p = 0; p < k; ++p, panel += 8) {
+        __m256d b0 = _mm256_loadu_pd(panel);
+        __m256d b1 = _mm256_loadu_pd(panel + 4);
+        for (int r = 0; r < MR; ++r) {
+            __m256d a = _mm256_broadcast_sd(A + r * lda + p);
+            c0[r] = _mm256_fmadd_pd(a, b0, c0[r]);
+            c1[r] = _mm256_fmadd_pd(a, b1, c1[r]);
+        }
+    }
+    for (int r = 0; r < MR; ++r) {
+        _mm256_maskstore_pd(C + r * ldc, mask0, c0[r]);
+        _mm256_maskstore_pd(C + r * ldc + 4, mask1, c1[r]);
+    }
+}
+
+// C[m x n] += A[m x k] * panel, where panel is one packed B panel (n <= 8)
+void simd_gemm_packed_b(int m, int n, int k, const double* A, int lda,
+                        const double* panel, double* C, int ldc) {
+    int i = 0;
+    for (; i + 4 <= m; i += 4, A += 4 * lda, C += 4 * ldc) {
+        simd_tile_packed_b<4>(n, k, A, lda, panel, C, ldc);
+    }
+    switch (m - i) {
+    case 3:
+        simd_tile_packed_b<3>(n, k, A, lda, panel, C, ldc);
+        break;
+    case 2:
+        simd_tile_packed_b<2>(n, k, A, lda, panel, C, ldc);
+        break;
+    case 1:
+        simd_tile_packed_b<1>(n, k, A, lda, panel, C, ldc);
+        break;
+    default:
+        break;
+    }
+}
+
+// C[m x n] += panel * B[k x n], where panel is one packed A panel (m <= 4).
+// The panel is zero-padded to 4 rows, so all four rows are computed and only
+// the first m are stored.
+void simd_gemm_packed_a(int m, int n, int k, const double* panel,
+                        const double* B, int ldb, double* C, int ldc) {
+    for (int j = 0; j < n; j += 8, B += 8, C += 8) {
+        int width = n - j < 8 ? n - j : 8;
+        __m256i mask0 = simd_lane_mask(width < 4 ? width : 4);
+        __m256i mask1 = simd_lane_mask(width > 4 ? width - 4 : 0);
+        __m256d c0[4], c1[4];
+        for (int r = 0; r < 4; ++r) {
+            c0[r] = _mm256_setzero_pd();
+            c1[r] = _mm256_setzero_pd();
+        }
+        const double* a = panel;
+        const double* b = B;
+        for (int p = 0; p < k; ++p, a += 4, b += ldb) {
+            __m256d b0 = _mm256_maskload_pd(b, mask0);
+            __m256d b1 = _mm256_maskload_pd(b + 4, mask1);
+            for (int r = 0; r < 4; ++r) {
+                __m256d av = _mm256_broadcast_sd(a + r);
+                c0[r] = _mm256_fmadd_pd(av, b0, c0[r]);
+                c1[r] = _mm256_fmadd_pd(av, b1, c1[r]);
+            }
+        }
+        for (int r = 0; r < m; ++r) {
+            double* cRow = C + r * ldc;
+            _mm256_maskstore_pd(cRow, mask0, _mm256_add_pd(c0[r], _mm256_maskload_pd(cRow, mask0)));
+            _mm256_maskstore_pd(cRow + 4, mask1, _mm256_add_pd(c1[r], _mm256_maskload_pd(cRow + 4, mask1)));
+        }
+    }
+}
+
+// C[m x n] = C add (panelA mul panelB) for one packed A panel (m <= 4) and one
+// packed B panel (n <= 8)
+template <class S>
+void simd_semiring_gemm_packed_ab(int m, int n, int k, const double* panelA, const double* panelB,
+                                  double* C, int ldc) {
+    __m256d c0[4], c1[4];
+    for (int r = 0; r < 4; ++r) {
+        c0[r] = _mm256_set1_pd(S::zero());
+        c1[r] = _mm256_set1_pd(S::zero());
+    }
+    for (int p = 0; p < k; ++p, panelA += 4, panelB += 8) {
+        __m256d b0 = _mm256_loadu_pd(panelB);
+        __m256d b1 = _mm256_loadu_pd(panelB + 4);
+        for (int r = 0; r < 4; ++r) {
+            __m256d a = _mm256_broadcast_sd(panelA + r);
+            c0[r] = S::mulAdd(a, b0, c0[r]);
+            c1[r] = S::mulAdd(a, b1, c1[r]);
+        }
+    }
+    if (n == 8) {
+        for (int r = 0; r < m; ++r) {
+            double* cRow = C + r * ldc;
+            _mm256_storeu_pd(cRow, S::add(c0[r], _mm256_loadu_pd(cRow)));
+            _mm256_storeu_pd(cRow + 4, S::add(c1[r], _mm256_loadu_pd(cRow + 4)));
+        }
+        return;
+    }
+    __m256i mask0 = simd_lane_mask(n < 4 ? n : 4);
+    __m256i mask1 = simd_lane_mask(n > 4 ? n - 4 : 0);
+    for (int r = 0; r < m; ++r) {
+        double* cRow = C + r * ldc;
+        _mm256_maskstore_pd(cRow, mask0, S::add(c0[r], _mm256_maskload_pd(cRow, mask0)));
+        _mm256_maskstore_pd(cRow + 4, mask1, S::add(c1[r], _mm256_maskload_pd(cRow + 4, mask1)));
+    }
+}
+
+// C[m x n] += panelA * panelB for one packed A panel (m <= 4) and one packed
+// B panel (n <= 8): the micro-kernel of the combined engine
+void simd_gemm_packed_ab(int m, int n, int k, const double* panelA, const double* panelB,
+                         double* C, int ldc) {
+    simd_semiring_gemm_packed_ab<PlusTimes>(m, n, k, panelA, panelB, C, ldc);
+}
+
+// Instantiations for the semirings of semiring.hpp
+template void simd_semiring_gemm_block<PlusTimes>(int, int, int, const double*, int, const double*, int, double*, int);
+template void simd_semiring_gemm_block<MinPlus>(int, int, int, const double*, int, const double*, int, double*, int);
+template void simd_semiring_gemm_block<MaxPlus>(int, int, int, const double*, int, const double*, int, double*, int);
+template void simd_semiring_gemm_block<MaxTimes>(int, int, int, const double*, int, const double*, int, double*, int);
+template void simd_semiring_gemm_packed_ab<PlusTimes>(int, int, int, const double*, const double*, double*, int);
+template void simd_semiring_gemm_packed_ab<MinPlus>(int, int, int, const double*, const double*, double*, int);
+template void simd_semiring_gemm_packed_ab<MaxPlus>(int, int, int, const double*, const double*, double*, int);
+template void simd_semiring_gemm_packed_ab<MaxTimes>(int, int, int, const double*, const double*, double*, int);
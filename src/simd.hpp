@@ -1,15 +1,54 @@
 #ifndef SIMD_HPP
 #define SIMD_HPP
 
+#include "epilogue.hpp"
 #include "matrix.hpp"
+#include "packed_matrix.hpp"
+#include "semiring.hpp"
 
 // Function to perform dense-dense matrix multiplication using SIMD
-Matrix simd_dense_dense_multiply(const Matrix& A, const Matrix& B);
+Matrix simd_dense_dense_multiply(const MatrixView& A, const MatrixView& B);
+
+// Dense-dense multiplication using SIMD, running the epilogue on each row of
+// the result as soon as it is complete
+Matrix simd_dense_dense_multiply_with_epilogue(const MatrixView& A, const MatrixView& B,
+                                               const Epilogue& epilogue);
+
+// Dense-dense multiplication with one operand prepacked (packed micro-kernels)
+Matrix simd_dense_dense_multiply_packed(const MatrixView& A, const PackedMatrix& B);
+Matrix simd_dense_dense_multiply_packed(const PackedMatrix& A, const MatrixView& B);
 
 // Function to perform dense-sparse matrix multiplication using SIMD
-Matrix simd_dense_sparse_multiply(const Matrix& A, const Matrix& B);
+Matrix simd_dense_sparse_multiply(const MatrixView& A, const MatrixView& B);
 
 // Function to perform sparse-sparse matrix multiplication using SIMD
-Matrix simd_sparse_sparse_multiply(const Matrix& A, const Matrix& B);
+Matrix simd_sparse_sparse_multiply(const MatrixView& A, const MatrixView& B);
+
+// Register-blocked AVX2 kernel: C[m x n] += A[m x k] * B[k x n] for row-major
+// operands with leading dimensions lda, ldb and ldc. Computes 4x8 tiles of C in
+// registers; edges fall back to narrower tiles and masked loads.
+void simd_gemm_block(int m, int n, int k, const double* A, int lda,
+                     const double* B, int ldb, double* C, int ldc);
+
+// Packed-operand kernels consuming PackedMatrix panels (see packed_matrix.hpp).
+// simd_gemm_packed_b: C[m x n] += A[m x k] * panel for one B panel (n <= 8).
+// simd_gemm_packed_a: C[m x n] += panel * B[k x n] for one A panel (m <= 4).
+// simd_gemm_packed_ab: C[m x n] += panelA * panelB with both sides packed.
+void simd_gemm_packed_b(int m, int n, int k, const double* A, int lda,
+                        const double* panel, double* C, int ldc);
+void simd_gemm_packed_a(int m, int n, int k, const double* panel,
+                        const double* B, int ldb, double* C, int ldc);
+void simd_gemm_packed_ab(int m, int n, int k, const double* panelA, const double* panelB,
+                         double* C, int ldc);
+
+// Semiring versions of simd_gemm_block and simd_gemm_packed_ab: the same
+// register blocking with S::mulAdd in place of fmadd, so C = C add (A mul B).
+// Instantiated for the policies of semiring.hpp.
+template <class S>
+void simd_semiring_gemm_block(int m, int n, int k, const double* A, int lda,
+                              const double* B, int ldb, double* C, int ldc);
+template <class S>
+void simd_semiring_gemm_packed_ab(int m, int n, int k, const double* panelA, const double* panelB,
+                                  double* C, int ldc);
 
 #endif // SIMD_HPP
@@ -0,0 +1,274 @@
+#include "sparse_benchmark.hpp"
+#include "bsr_matrix.hpp"
+#include "bsr_multiply.hpp"
+#include "cache_optimization.hpp"
+#include "combined_multiply.hpp"
+#include "compressed_csr.hpp"
+#include "csr_matrix.hpp"
+#include "multithreading.hpp"
+#include "reordering.hpp"
+#include "sell_matrix.hpp"
+#include "sparse_generators.hpp"
+#include "spgemm.hpp"
+#include "spmv.hpp"
+#include "verification.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Columns of the dense right-hand side of the sparse - dense cases
+const int kDenseColumns = 64;
+
+// Relative error allowed for engines that store values as float
+const double kFloatTolerance = 1e-6;
+
+// Largest size at which the engines that need a dense copy of A, including
+// the dense baseline, are run; above it their O(n^2) cost swamps the suite
+const int kDenseSizeLimit = 2048;
+
+typedef std::chrono::steady_clock Clock;
+
+// An engine run on one workload, returning its product as Result.
+// Conversion of the operands happens in prepare, outside the timed run.
+template <class Result>
+struct EngineCase {
+    std::string name;
+    std::function<void()> prepare;
+    std::function<Result()> run;
+    double tolerance; // Verification tolerance (0 for the default)
+};
+
+// Time one engine case and check its product against A * B with a Freivalds test
+template <class Result, class MatrixA, class MatrixB>
+void runCase(const EngineCase<Result>& engine, const MatrixA& A, const MatrixB& B) {
+    std::cout << "  " << std::left << std::setw(38) << engine.name << std::right;
+    try {
+        if (engine.prepare) {
+            engine.prepare();
+        }
+        Clock::time_point start = Clock::now();
+        Result C = engine.run();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        VerifyOptions options;
+        options.tolerance = engine.tolerance;
+        VerifyResult check = verifyProduct(A, B, C, options);
+        std::cout << std::fixed << std::setprecision(4) << std::setw(10) << seconds << " s  "
+                  << (check.passed ? "ok" : "MISMATCH") << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "error: " << e.what() << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+}
+
+// Largest number of non-zeros in one row
+int maxRowLength(const CSRMatrix& M) {
+    int longest = 0;
+    for (int i = 0; i < M.getRows(); ++i) {
+        longest = std::max(longest, M.rowPtr[i + 1] - M.rowPtr[i]);
+    }
+    return longest;
+}
+
+// A * A with every sparse - sparse engine, then A * X with every sparse - dense
+// one. Engines that need a dense A only run up to kDenseSizeLimit.
+void runWorkload(const SparseWorkload& workload, unsigned long long seed) {
+    const CSRMatrix& csr = workload.matrix;
+    int n = csr.getRows();
+    bool withDense = n <= kDenseSizeLimit;
+    Matrix A = withDense ? csr.toDense() : Matrix(0, 0);
+    std::cout << workload.name << " (" << workload.parameters << "): nnz " << csr.getNonZeros()
+              << ", max row " << maxRowLength(csr) << ", CSR " << csrStoredBytes(csr) / 1e6 << " MB, compressed "
+              << CompressedCSRMatrix(csr).getStoredBytes() / 1e6 << " MB (fp64) "
+              << CompressedCSRMatrix(csr, ValuePrecision::Float).getStoredBytes() / 1e6 << " MB (fp32)" << std::endl;
+    if (!withDense) {
+        std::cout << " (BSR, threaded, tile map and dense baseline skipped above size " << kDenseSizeLimit << ")"
+                  << std::endl;
+    }
+
+    // Operands converted by prepare and shared by the run that follows
+    CSRMatrix csrOperand(0, 0);
+    BSRMatrix bsrOperand(0, 0, 1);
+    std::vector<SellCSigmaMatrix> sellOperand;
+    std::vector<CompressedCSRMatrix> compressedOperand;
+    std::vector<std::string> reorderings;
+
+    std::vector<EngineCase<CSRMatrix>> sparseSparse = {
+        {"CSR SpGEMM", [&] { csrOperand = csr; }, [&] { return sparseSparseMultiplyCSR(csrOperand, csrOperand); }},
+        {"CSR SpGEMM (reordered, auto)", nullptr,
+         [&] {
+             Reordering plan;
+             CSRMatrix C = sparseSparseMultiplyReordered(csr, csr, ReorderMethod::Auto, &plan);
+             reorderings.push_back("SpGEMM " + plan.toString());
+             return C;
+         }},
+    };
+    std::vector<EngineCase<Matrix>> denseSparse;
+    if (withDense) {
+        denseSparse = {
+            {"BSR x BSR", [&] { bsrOperand = BSRMatrix(A); },
+             [&] { return bsrBsrMultiply(bsrOperand, bsrOperand).toDense(); }},
+            {"Threaded sparse-sparse", nullptr, [&] { return sparseSparseMultiplyThreaded(A, A); }},
+            {"Threaded dense-sparse", nullptr, [&] { return denseSparseMultiplyThreaded(A, A); }},
+            {"Tile map blocked", nullptr, [&] { return cache_optimized_multiply_sparse_sparse(A, A); }},
+            {"Combined dense (baseline)", nullptr, [&] { return combinedDenseMultiply(A, A); }},
+        };
+    }
+    std::cout << " A * A" << std::endl;
+    for (const EngineCase<CSRMatrix>& engine : sparseSparse) {
+        runCase(engine, csr, csr);
+    }
+    for (const EngineCase<Matrix>& engine : denseSparse) {
+        runCase(engine, A, A);
+    }
+
+    // A * x, with x and y as single-column matrices for the check
+    Matrix x = generateUniform(n, 1, 1.0, seed).toDense();
+    std::vector<double> xVector(n);
+    for (int i = 0; i < n; ++i) {
+        xVector[i] = x.get(i, 0);
+    }
+    auto asColumn = [](const std::vector<double>& y) {
+        Matrix column(static_cast<int>(y.size()), 1);
+        for (int i = 0; i < column.getRows(); ++i) {
+            column.set(i, 0, y[i]);
+        }
+        return column;
+    };
+    std::vector<EngineCase<Matrix>> sparseVector = {
+        {"SELL-C-sigma SpMV", [&] { sellOperand.assign(1, SellCSigmaMatrix(csr)); },
+         [&] {
+             std::vector<double> y;
+             sellSpMV(sellOperand[0], xVector, y);
+             return asColumn(y);
+         }},
+        {"Compressed CSR SpMV (fp64)", [&] { compressedOperand.assign(1, CompressedCSRMatrix(csr)); },
+         [&] {
+             std::vector<double> y;
+             compressedSpMV(compressedOperand[0], xVector, y);
+             return asColumn(y);
+         }},
+        {"Compressed CSR SpMV (fp32 values)",
+         [&] { compressedOperand.assign(1, CompressedCSRMatrix(csr, ValuePrecision::Float)); },
+         [&] {
+             std::vector<double> y;
+             compressedSpMV(compressedOperand[0], xVector, y);
+             return asColumn(y);
+         }, kFloatTolerance},
+    };
+    std::cout << " A * x" << std::endl;
+    for (const EngineCase<Matrix>& engine : sparseVector) {
+        runCase(engine, csr, x);
+    }
+
+    Matrix X = generateUniform(n, kDenseColumns, 1.0, seed).toDense();
+    std::vector<EngineCase<Matrix>> sparseDense = {
+        {"SELL-C-sigma SpMM", [&] { sellOperand.assign(1, SellCSigmaMatrix(csr)); },
+         [&] { return sellSpMM(sellOperand[0], X); }},
+        {"SELL-C-sigma SpMM (incl. conversion)", nullptr,
+         [&] { return sellSpMM(SellCSigmaMatrix(csr), X); }},
+        {"SELL-C-sigma SpMM (reordered, auto)", nullptr,
+         [&] {
+             Reordering plan;
+             Matrix Y = sellSpMMReordered(csr, X, ReorderMethod::Auto, &plan);
+             reorderings.push_back("SpMM " + plan.toString());
+             return Y;
+         }},
+        {"Compressed CSR SpMM (fp64)", [&] { compressedOperand.assign(1, CompressedCSRMatrix(csr)); },
+         [&] { return compressedSpMM(compressedOperand[0], X); }},
+        {"Compressed CSR SpMM (fp32 values)",
+         [&] { compressedOperand.assign(1, CompressedCSRMatrix(csr, ValuePrecision::Float)); },
+         [&] { return compressedSpMM(compressedOperand[0], X); }, kFloatTolerance},
+    };
+    if (withDense) {
+        sparseDense.push_back({"BSR x dense", [&] { bsrOperand = BSRMatrix(A); },
+                               [&] { return bsrDenseMultiply(bsrOperand, X); }, 0.0});
+        sparseDense.push_back({"Tile map blocked", nullptr,
+                               [&] { return cache_optimized_multiply_dense_sparse(A, X); }, 0.0});
+        sparseDense.push_back({"Combined dense (baseline)", nullptr,
+                               [&] { return combinedDenseMultiply(A, X); }, 0.0});
+    }
+    std::cout << " A * X (" << n << " x " << kDenseColumns << " dense)" << std::endl;
+    for (const EngineCase<Matrix>& engine : sparseDense) {
+        runCase(engine, csr, X);
+    }
+    for (const std::string& line : reorderings) {
+        std::cout << " Reordering for " << line << std::endl;
+    }
+}
+
+// Apply one random permutation to the rows and columns of M, which hides the
+// structure of the pattern from the engines (but not from reordering)
+CSRMatrix shuffleSymmetric(const CSRMatrix& M, unsigned long long seed) {
+    std::vector<int> order(M.getRows());
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937_64 rng(seed);
+    std::shuffle(order.begin(), order.end(), rng);
+    return permuteCSR(M, order, order);
+}
+
+} // namespace
+
+// Generate the suite and run every engine over it
+int runSparseBenchmark(int argc, char* argv[]) {
+    int size = 32768; // CSR A at degree 16 is about 6 MB, beyond the L2 the reordering planner models
+    double degree = 16.0;
+    unsigned long long seed = 1;
+    std::string pattern;
+    bool shuffle = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) {
+            size = std::atoi(argv[++i]);
+        } else if (arg == "--degree" && i + 1 < argc) {
+            degree = std::atof(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--pattern" && i + 1 < argc) {
+            pattern = argv[++i];
+        } else if (arg == "--shuffle") {
+            shuffle = true;
+        }
+    }
+    if (size < 1 || degree <= 0.0) {
+        std::cerr << "Usage: " << argv[0]
+                  << " --sparse-bench [--size N] [--degree D] [--seed S] [--pattern NAME] [--shuffle]" << std::endl;
+        return 1;
+    }
+
+    try {
+        std::vector<SparseWorkload> suite = makeSparseWorkloadSuite(size, degree, seed);
+        bool found = false;
+        for (SparseWorkload& workload : suite) {
+            if (!pattern.empty() && workload.name != pattern) {
+                continue;
+            }
+            found = true;
+            if (shuffle) {
+                workload.matrix = shuffleSymmetric(workload.matrix, seed);
+                workload.parameters += ", shuffled";
+            }
+            runWorkload(workload, seed);
+        }
+        if (!found) {
+            std::cerr << "Unknown pattern: " << pattern << " (one of";
+            for (const SparseWorkload& workload : suite) {
+                std::cerr << " " << workload.name;
+            }
+            std::cerr << ")" << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,12 @@
+#ifndef SPARSE_BENCHMARK_HPP
+#define SPARSE_BENCHMARK_HPP
+
+// Run every sparse engine over the generated workload suite (see
+// sparse_generators.hpp) from command-line options (--size N, --degree D,
+// --seed S, --pattern NAME to run a single generator, --shuffle to hide the
+// structure behind a random symmetric permutation) and print a time per
+// engine and workload; returns an exit code. Engines that need a dense copy
+// of the matrix only run on small sizes.
+int runSparseBenchmark(int argc, char* argv[]);
+
+#endif // SPARSE_BENCHMARK_HPP
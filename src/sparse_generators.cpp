@@ -0,0 +1,282 @@
+#include "sparse_generators.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+typedef std::mt19937_64 Generator;
+
+// Attempts at repairing a collision of the random regular construction
+const int kRegularRepairTries = 1000;
+
+// Random non-zero value in [1, 10)
+double randomValue(Generator& rng) {
+    return std::uniform_real_distribution<double>(1.0, 10.0)(rng);
+}
+
+// Uniform integer in [0, bound)
+int randomIndex(Generator& rng, int bound) {
+    return std::uniform_int_distribution<int>(0, bound - 1)(rng);
+}
+
+bool chance(Generator& rng, double probability) {
+    return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < probability;
+}
+
+void checkSize(int rows, int cols) {
+    if (rows < 0 || cols < 0) {
+        throw std::invalid_argument("Matrix dimensions must not be negative.");
+    }
+}
+
+// Element of a pattern under construction
+struct Triplet {
+    int row;
+    int col;
+    double value;
+};
+
+// CSR from elements in any order; of repeated elements the first one is kept
+CSRMatrix fromTriplets(int rows, int cols, std::vector<Triplet>& triplets) {
+    std::stable_sort(triplets.begin(), triplets.end(), [](const Triplet& x, const Triplet& y) {
+        return x.row != y.row ? x.row < y.row : x.col < y.col;
+    });
+    CSRMatrix M(rows, cols);
+    M.colIndices.reserve(triplets.size());
+    M.values.reserve(triplets.size());
+    for (size_t t = 0; t < triplets.size(); ++t) {
+        if (t > 0 && triplets[t].row == triplets[t - 1].row && triplets[t].col == triplets[t - 1].col) {
+            continue;
+        }
+        M.colIndices.push_back(triplets[t].col);
+        M.values.push_back(triplets[t].value);
+        ++M.rowPtr[triplets[t].row + 1];
+    }
+    for (int i = 0; i < rows; ++i) {
+        M.rowPtr[i + 1] += M.rowPtr[i];
+    }
+    return M;
+}
+
+// Append one element to the last row of M under construction (columns ascending)
+void append(CSRMatrix& M, int col, double value) {
+    M.colIndices.push_back(col);
+    M.values.push_back(value);
+}
+
+// Close row i of M under construction
+void endRow(CSRMatrix& M, int i) {
+    M.rowPtr[i + 1] = static_cast<int>(M.colIndices.size());
+}
+
+} // namespace
+
+// Uniformly random pattern: the gaps between non-zeros of a row are
+// geometric, so only the non-zeros are drawn
+CSRMatrix generateUniform(int rows, int cols, double density, unsigned long long seed) {
+    checkSize(rows, cols);
+    Generator rng(seed);
+    CSRMatrix M(rows, cols);
+    if (density <= 0.0) {
+        return M;
+    }
+    std::geometric_distribution<long long> gap(std::min(1.0, density));
+    for (int i = 0; i < rows; ++i) {
+        for (long long j = gap(rng); j < cols; j += 1 + gap(rng)) {
+            append(M, static_cast<int>(j), randomValue(rng));
+        }
+        endRow(M, i);
+    }
+    return M;
+}
+
+// R-MAT graph: recurse into one quadrant per level of the next power of two
+// above n; edges falling outside n x n are drawn again
+CSRMatrix generateRmat(int n, double averageDegree, unsigned long long seed, double a, double b, double c) {
+    checkSize(n, n);
+    if (a < 0 || b < 0 || c < 0 || a + b + c > 1.0) {
+        throw std::invalid_argument("R-MAT quadrant probabilities must be non-negative and sum to at most 1.");
+    }
+    Generator rng(seed);
+    int levels = 0;
+    while ((1LL << levels) < n) {
+        ++levels;
+    }
+
+    long long edges = std::llround(averageDegree * n);
+    std::vector<Triplet> triplets;
+    triplets.reserve(static_cast<size_t>(std::max(0LL, edges)));
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (long long e = 0; e < edges && n > 0;) {
+        int row = 0;
+        int col = 0;
+        for (int level = 0; level < levels; ++level) {
+            double r = unit(rng);
+            int down = r >= a + b ? 1 : 0;
+            int right = (r >= a && r < a + b) || r >= a + b + c ? 1 : 0;
+            row = row * 2 + down;
+            col = col * 2 + right;
+        }
+        if (row >= n || col >= n) {
+            continue;
+        }
+        triplets.push_back({row, col, randomValue(rng)});
+        ++e;
+    }
+    return fromTriplets(n, n, triplets);
+}
+
+// Banded pattern around the diagonal
+CSRMatrix generateBanded(int n, int halfBandwidth, double bandDensity, unsigned long long seed) {
+    checkSize(n, n);
+    Generator rng(seed);
+    CSRMatrix M(n, n);
+    for (int i = 0; i < n; ++i) {
+        int first = std::max(0, i - halfBandwidth);
+        int last = std::min(n - 1, i + halfBandwidth);
+        for (int j = first; j <= last; ++j) {
+            if (j == i || chance(rng, bandDensity)) {
+                append(M, j, randomValue(rng));
+            }
+        }
+        endRow(M, i);
+    }
+    return M;
+}
+
+// Diagonal blocks
+CSRMatrix generateBlockDiagonal(int n, int blockSize, double blockDensity, unsigned long long seed) {
+    checkSize(n, n);
+    if (blockSize < 1) {
+        throw std::invalid_argument("Block size must be positive.");
+    }
+    Generator rng(seed);
+    CSRMatrix M(n, n);
+    for (int i = 0; i < n; ++i) {
+        int first = i / blockSize * blockSize;
+        int last = std::min(n, first + blockSize);
+        for (int j = first; j < last; ++j) {
+            if (chance(rng, blockDensity)) {
+                append(M, j, randomValue(rng));
+            }
+        }
+        endRow(M, i);
+    }
+    return M;
+}
+
+// Union of degree random permutations; a row whose new column is already
+// taken swaps targets with a random row for which the swap is valid too
+CSRMatrix generateRandomRegular(int n, int degree, unsigned long long seed) {
+    checkSize(n, n);
+    if (degree < 0 || degree > n) {
+        throw std::invalid_argument("Degree must be between 0 and the matrix size.");
+    }
+    Generator rng(seed);
+    std::vector<std::vector<int>> taken(n); // Columns of each row so far
+    auto isTaken = [&](int row, int col) {
+        return std::find(taken[row].begin(), taken[row].end(), col) != taken[row].end();
+    };
+    std::vector<Triplet> triplets;
+    triplets.reserve(static_cast<size_t>(n) * degree);
+    std::vector<int> target(n);
+    for (int round = 0; round < degree; ++round) {
+        std::iota(target.begin(), target.end(), 0);
+        std::shuffle(target.begin(), target.end(), rng);
+        for (int i = 0; i < n; ++i) {
+            if (!isTaken(i, target[i])) {
+                continue;
+            }
+            int tries = 0;
+            for (; tries < kRegularRepairTries; ++tries) {
+                int j = randomIndex(rng, n);
+                if (!isTaken(i, target[j]) && !isTaken(j, target[i])) {
+                    std::swap(target[i], target[j]);
+                    break;
+                }
+            }
+            if (tries == kRegularRepairTries) {
+                throw std::runtime_error("Could not build a random regular pattern; lower the degree.");
+            }
+        }
+        for (int i = 0; i < n; ++i) {
+            taken[i].push_back(target[i]);
+            triplets.push_back({i, target[i], randomValue(rng)});
+        }
+    }
+    return fromTriplets(n, n, triplets);
+}
+
+// Power-law row lengths; columns of a row are drawn without repetition
+// (Floyd's algorithm, with a marker per column reset after each row)
+CSRMatrix generateRowSkewed(int rows, int cols, double averageDegree, double exponent, unsigned long long seed) {
+    checkSize(rows, cols);
+    Generator rng(seed);
+    if (rows == 0 || cols == 0) {
+        return CSRMatrix(rows, cols);
+    }
+
+    std::vector<double> weight(rows);
+    for (int r = 0; r < rows; ++r) {
+        weight[r] = std::pow(r + 1.0, -exponent);
+    }
+    std::shuffle(weight.begin(), weight.end(), rng);
+    double total = std::accumulate(weight.begin(), weight.end(), 0.0);
+
+    double budget = averageDegree * rows;
+    std::vector<Triplet> triplets;
+    std::vector<char> used(cols, 0);
+    std::vector<int> picked;
+    for (int i = 0; i < rows; ++i) {
+        int length = static_cast<int>(std::min<double>(cols, std::floor(budget * weight[i] / total + 0.5)));
+        picked.clear();
+        for (int j = cols - length; j < cols; ++j) {
+            int pick = std::uniform_int_distribution<int>(0, j)(rng);
+            int col = used[pick] ? j : pick;
+            used[col] = 1;
+            picked.push_back(col);
+            triplets.push_back({i, col, randomValue(rng)});
+        }
+        for (int col : picked) {
+            used[col] = 0;
+        }
+    }
+    return fromTriplets(rows, cols, triplets);
+}
+
+// One matrix from every generator
+std::vector<SparseWorkload> makeSparseWorkloadSuite(int n, double averageDegree, unsigned long long seed) {
+    std::vector<SparseWorkload> suite;
+    int degree = std::max(1, static_cast<int>(std::lround(averageDegree)));
+    int blockSize = std::min(std::max(1, n), std::max(16, 4 * degree));
+    std::ostringstream text;
+
+    text << "density " << averageDegree / std::max(1, n);
+    suite.push_back({"uniform", text.str(), generateUniform(n, n, averageDegree / std::max(1, n), seed)});
+
+    text.str("");
+    text << "average degree " << averageDegree << ", a=0.57 b=0.19 c=0.19";
+    suite.push_back({"rmat", text.str(), generateRmat(n, averageDegree, seed + 1)});
+
+    text.str("");
+    text << "half bandwidth " << degree << ", band density 0.5";
+    suite.push_back({"banded", text.str(), generateBanded(n, degree, 0.5, seed + 2)});
+
+    text.str("");
+    text << "block size " << blockSize << ", block density " << averageDegree / blockSize;
+    suite.push_back({"block-diagonal", text.str(),
+                     generateBlockDiagonal(n, blockSize, averageDegree / blockSize, seed + 3)});
+
+    text.str("");
+    text << "degree " << std::min(degree, n);
+    suite.push_back({"random-regular", text.str(), generateRandomRegular(n, std::min(degree, n), seed + 4)});
+
+    text.str("");
+    text << "average degree " << averageDegree << ", exponent 1";
+    suite.push_back({"row-skewed", text.str(), generateRowSkewed(n, n, averageDegree, 1.0, seed + 5)});
+    return suite;
+}
@@ -0,0 +1,51 @@
+#ifndef SPARSE_GENERATORS_HPP
+#define SPARSE_GENERATORS_HPP
+
+#include "csr_matrix.hpp"
+#include <string>
+#include <vector>
+
+// Structured sparse test matrices. Every generator is deterministic for a
+// given seed, non-zero values are uniform in [1, 10), and the matrix is built
+// in CSR directly, in time and memory proportional to its non-zeros (plus the
+// rows), so the sizes that exceed the caches stay cheap to generate.
+
+// Uniformly random pattern (like fillRandom, but seeded): each element is
+// non-zero with probability density
+CSRMatrix generateUniform(int rows, int cols, double density, unsigned long long seed);
+
+// R-MAT (recursive Kronecker) power-law graph with about averageDegree * n
+// edges: every edge picks one of the four quadrants with probabilities a, b,
+// c and 1 - a - b - c at each level of the recursion. Duplicate edges are
+// merged, so the actual count is somewhat lower.
+CSRMatrix generateRmat(int n, double averageDegree, unsigned long long seed,
+                    double a = 0.57, double b = 0.19, double c = 0.19);
+
+// Banded system (FEM-like): the diagonal plus each element within
+// halfBandwidth of it with probability bandDensity
+CSRMatrix generateBanded(int n, int halfBandwidth, double bandDensity, unsigned long long seed);
+
+// Dense-ish diagonal blocks of blockSize (the last may be smaller), each
+// element non-zero with probability blockDensity
+CSRMatrix generateBlockDiagonal(int n, int blockSize, double blockDensity, unsigned long long seed);
+
+// Random regular pattern: every row and every column holds exactly degree
+// non-zeros (the union of degree random permutations that do not collide)
+CSRMatrix generateRandomRegular(int n, int degree, unsigned long long seed);
+
+// Row-skewed pattern: row lengths follow a power law with the given exponent
+// (row r, in random order, gets a share proportional to (r + 1)^-exponent) and
+// average averageDegree; columns within a row are uniform
+CSRMatrix generateRowSkewed(int rows, int cols, double averageDegree, double exponent, unsigned long long seed);
+
+// A generated matrix and how it was made
+struct SparseWorkload {
+    std::string name;       // Generator
+    std::string parameters; // Human-readable parameters
+    CSRMatrix matrix;
+};
+
+// One n x n matrix from every generator at roughly averageDegree non-zeros per row
+std::vector<SparseWorkload> makeSparseWorkloadSuite(int n, double averageDegree, unsigned long long seed);
+
+#endif // SPARSE_GENERATORS_HPP
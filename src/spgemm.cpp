@@ -0,0 +1,292 @@
+#include "spgemm.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// A row uses the dense accumulator once its flops reach cols / ratio;
+// sparser rows use a small hash table that stays in cache
+const long long kDenseAccumulatorRatio = 8;
+
+// Target amount of work (multiply-adds) per scheduled chunk of rows
+const long long kFlopsPerChunk = 1 << 16;
+
+// Per-thread scratch space, reused across rows and across calls
+struct Workspace {
+    std::vector<int> marker;      // Dense accumulator: stamp of the row that last touched a column
+    std::vector<double> dense;    // Dense accumulator: partial sums
+    std::vector<int> touched;     // Dense accumulator: columns touched by the current row
+    std::vector<int> hashKeys;    // Hash accumulator: column (-1 when the slot is empty)
+    std::vector<double> hashVals; // Hash accumulator: partial sums
+    std::vector<std::pair<int, double>> entries; // Hash accumulator: row output before sorting
+    int stamp = 0;
+
+    // Start a new row on the dense accumulator
+    void beginDenseRow(int cols) {
+        if (static_cast<int>(marker.size()) < cols) {
+            marker.resize(cols, 0);
+            dense.resize(cols);
+        }
+        if (stamp == INT_MAX) {
+            std::fill(marker.begin(), marker.end(), 0);
+            stamp = 0;
+        }
+        ++stamp;
+        touched.clear();
+    }
+
+    // Start a new row on the hash accumulator and return the table mask
+    unsigned beginHashRow(long long flops) {
+        unsigned size = 16;
+        while (size < 2 * flops) {
+            size <<= 1;
+        }
+        if (hashKeys.size() < size) {
+            hashKeys.resize(size);
+            hashVals.resize(size);
+        }
+        std::fill(hashKeys.begin(), hashKeys.begin() + size, -1);
+        return size - 1;
+    }
+};
+
+Workspace& threadWorkspace() {
+    static thread_local Workspace workspace;
+    return workspace;
+}
+
+// Find (or claim) the hash slot of column col
+inline unsigned hashSlot(Workspace& ws, unsigned mask, int col, bool& inserted) {
+    unsigned slot = (static_cast<unsigned>(col) * 2654435761u) & mask;
+    while (ws.hashKeys[slot] != col) {
+        if (ws.hashKeys[slot] == -1) {
+            ws.hashKeys[slot] = col;
+            inserted = true;
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    inserted = false;
+    return slot;
+}
+
+// Symbolic phase for one row: number of distinct output columns
+int countRow(const CSRMatrix& A, const CSRMatrix& B, int row, long long flops) {
+    Workspace& ws = threadWorkspace();
+    int count = 0;
+
+    if (flops * kDenseAccumulatorRatio >= B.getCols()) {
+        ws.beginDenseRow(B.getCols());
+        for (int p = A.rowPtr[row]; p < A.rowPtr[row + 1]; ++p) {
+            int k = A.colIndices[p];
+            for (int q = B.rowPtr[k]; q < B.rowPtr[k + 1]; ++q) {
+                int col = B.colIndices[q];
+                if (ws.marker[col] != ws.stamp) {
+                    ws.marker[col] = ws.stamp;
+                    ++count;
+                }
+            }
+        }
+    } else {
+        unsigned mask = ws.beginHashRow(flops);
+        bool inserted;
+        for (int p = A.rowPtr[row]; p < A.rowPtr[row + 1]; ++p) {
+            int k = A.colIndices[p];
+            for (int q = B.rowPtr[k]; q < B.rowPtr[k + 1]; ++q) {
+                hashSlot(ws, mask, B.colIndices[q], inserted);
+                if (inserted) {
+                    ++count;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// Numeric phase for one row over semiring S: write the sorted row into its
+// preallocated slice of C
+template <class S>
+void fillRow(const CSRMatrix& A, const CSRMatrix& B, CSRMatrix& C, int row, long long flops) {
+    Workspace& ws = threadWorkspace();
+    int out = C.rowPtr[row];
+
+    if (flops * kDenseAccumulatorRatio >= B.getCols()) {
+        ws.beginDenseRow(B.getCols());
+        for (int p = A.rowPtr[row]; p < A.rowPtr[row + 1]; ++p) {
+            int k = A.colIndices[p];
+            double a = A.values[p];
+            for (int q = B.rowPtr[k]; q < B.rowPtr[k + 1]; ++q) {
+                int col = B.colIndices[q];
+                if (ws.marker[col] != ws.stamp) {
+                    ws.marker[col] = ws.stamp;
+                    ws.dense[col] = S::mul(a, B.values[q]);
+                    ws.touched.push_back(col);
+                } else {
+                    ws.dense[col] = S::add(ws.dense[col], S::mul(a, B.values[q]));
+                }
+            }
+        }
+        std::sort(ws.touched.begin(), ws.touched.end());
+        for (int col : ws.touched) {
+            C.colIndices[out] = col;
+            C.values[out] = ws.dense[col];
+            ++out;
+        }
+    } else {
+        unsigned mask = ws.beginHashRow(flops);
+        bool inserted;
+        for (int p = A.rowPtr[row]; p < A.rowPtr[row + 1]; ++p) {
+            int k = A.colIndices[p];
+            double a = A.values[p];
+            for (int q = B.rowPtr[k]; q < B.rowPtr[k + 1]; ++q) {
+                unsigned slot = hashSlot(ws, mask, B.colIndices[q], inserted);
+                if (inserted) {
+                    ws.hashVals[slot] = S::mul(a, B.values[q]);
+                } else {
+                    ws.hashVals[slot] = S::add(ws.hashVals[slot], S::mul(a, B.values[q]));
+                }
+            }
+        }
+        ws.entries.clear();
+        for (unsigned slot = 0; slot <= mask; ++slot) {
+            if (ws.hashKeys[slot] != -1) {
+                ws.entries.push_back(std::make_pair(ws.hashKeys[slot], ws.hashVals[slot]));
+            }
+        }
+        std::sort(ws.entries.begin(), ws.entries.end());
+        for (const auto& entry : ws.entries) {
+            C.colIndices[out] = entry.first;
+            C.values[out] = entry.second;
+            ++out;
+        }
+    }
+}
+
+// Bin rows by log2 of their flops, heaviest bin first, and cut the ordered
+// rows into chunks of roughly kFlopsPerChunk work. Rows without work are dropped.
+void binRows(const std::vector<long long>& rowFlops, std::vector<int>& order,
+             std::vector<int>& chunkStarts) {
+    const int numBins = 64;
+    std::vector<int> binCounts(numBins + 1, 0);
+    std::vector<int> rowBin(rowFlops.size(), -1);
+
+    for (size_t i = 0; i < rowFlops.size(); ++i) {
+        if (rowFlops[i] == 0) {
+            continue;
+        }
+        int bin = 0;
+        for (long long f = rowFlops[i]; f > 1; f >>= 1) {
+            ++bin;
+        }
+        rowBin[i] = numBins - 1 - bin; // Heaviest rows get the lowest bin index
+        ++binCounts[rowBin[i] + 1];
+    }
+    for (int b = 0; b < numBins; ++b) {
+        binCounts[b + 1] += binCounts[b];
+    }
+
+    order.assign(binCounts[numBins], 0);
+    for (size_t i = 0; i < rowFlops.size(); ++i) {
+        if (rowBin[i] >= 0) {
+            order[binCounts[rowBin[i]]++] = static_cast<int>(i);
+        }
+    }
+
+    chunkStarts.clear();
+    long long chunkFlops = kFlopsPerChunk;
+    for (size_t p = 0; p < order.size(); ++p) {
+        if (chunkFlops >= kFlopsPerChunk) {
+            chunkStarts.push_back(static_cast<int>(p));
+            chunkFlops = 0;
+        }
+        chunkFlops += rowFlops[order[p]];
+    }
+    chunkStarts.push_back(static_cast<int>(order.size()));
+}
+
+// Parallel two-phase multiplication over semiring S
+template <class S>
+CSRMatrix multiplyCSR(const CSRMatrix& A, const CSRMatrix& B) {
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
+    int rows = A.getRows();
+    ThreadPool& pool = sharedThreadPool();
+    CSRMatrix C(rows, B.getCols());
+
+    // Estimate the work of every row: one multiply-add per (A(i,k), B(k,j)) pair
+    std::vector<long long> rowFlops(rows, 0);
+    pool.parallelFor(0, rows, 1024, [&](int lo, int hi) {
+        for (int i = lo; i < hi; ++i) {
+            long long flops = 0;
+            for (int p = A.rowPtr[i]; p < A.rowPtr[i + 1]; ++p) {
+                int k = A.colIndices[p];
+                flops += B.rowPtr[k + 1] - B.rowPtr[k];
+            }
+            rowFlops[i] = flops;
+        }
+    });
+
+    std::vector<int> order;
+    std::vector<int> chunkStarts;
+    binRows(rowFlops, order, chunkStarts);
+    int numChunks = static_cast<int>(chunkStarts.size()) - 1;
+
+    // Symbolic phase: exact size of every output row
+    std::vector<int> rowSizes(rows, 0);
+    pool.parallelFor(0, numChunks, 1, [&](int lo, int hi) {
+        for (int c = lo; c < hi; ++c) {
+            for (int p = chunkStarts[c]; p < chunkStarts[c + 1]; ++p) {
+                int row = order[p];
+                rowSizes[row] = countRow(A, B, row, rowFlops[row]);
+            }
+        }
+    });
+
+    long long total = 0;
+    for (int i = 0; i < rows; ++i) {
+        total += rowSizes[i];
+        if (total > INT_MAX) {
+            throw std::length_error("Sparse product has too many non-zero elements.");
+        }
+        C.rowPtr[i + 1] = static_cast<int>(total);
+    }
+    C.colIndices.resize(total);
+    C.values.resize(total);
+
+    // Numeric phase: fill the preallocated output
+    pool.parallelFor(0, numChunks, 1, [&](int lo, int hi) {
+        for (int c = lo; c < hi; ++c) {
+            for (int p = chunkStarts[c]; p < chunkStarts[c + 1]; ++p) {
+                int row = order[p];
+                fillRow<S>(A, B, C, row, rowFlops[row]);
+            }
+        }
+    });
+
+    return C;
+}
+
+} // namespace
+
+// Parallel two-phase sparse-sparse multiplication
+CSRMatrix sparseSparseMultiplyCSR(const CSRMatrix& A, const CSRMatrix& B) {
+    return multiplyCSR<PlusTimes>(A, B);
+}
+
+// Parallel two-phase sparse-sparse multiplication over a semiring
+template <class S>
+CSRMatrix sparseSemiringMultiplyCSR(const CSRMatrix& A, const CSRMatrix& B) {
+    return multiplyCSR<S>(A, B);
+}
+
+// Instantiations for the semirings of semiring.hpp
+template CSRMatrix sparseSemiringMultiplyCSR<PlusTimes>(const CSRMatrix&, const CSRMatrix&);
+template CSRMatrix sparseSemiringMultiplyCSR<MinPlus>(const CSRMatrix&, const CSRMatrix&);
+template CSRMatrix sparseSemiringMultiplyCSR<MaxPlus>(const CSRMatrix&, const CSRMatrix&);
+template CSRMatrix sparseSemiringMultiplyCSR<MaxTimes>(const CSRMatrix&, const CSRMatrix&);
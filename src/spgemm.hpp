@@ -0,0 +1,21 @@
+#ifndef SPGEMM_HPP
+#define SPGEMM_HPP
+
+#include "csr_matrix.hpp"
+#include "semiring.hpp"
+
+// Parallel two-phase sparse-sparse multiplication (row-wise Gustavson).
+// A symbolic pass computes the exact size of every output row, the output is
+// allocated once, and a numeric pass fills it in place. Each row accumulates
+// into a per-thread hash table or dense accumulator depending on its flops,
+// and rows are binned by cost so that heavy rows are scheduled first.
+CSRMatrix sparseSparseMultiplyCSR(const CSRMatrix& A, const CSRMatrix& B);
+
+// The same SpGEMM over semiring S (see semiring.hpp). Elements missing from A,
+// B or the result stand for S::zero(), e.g. +inf (no edge) for MinPlus; build
+// the operands with CSRMatrix(dense, S::zero()) and expand the result with
+// toDense(S::zero()).
+template <class S>
+CSRMatrix sparseSemiringMultiplyCSR(const CSRMatrix& A, const CSRMatrix& B);
+
+#endif // SPGEMM_HPP
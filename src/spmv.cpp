@@ -0,0 +1,402 @@
+#include "spmv.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <immintrin.h> // For AVX2 and FMA
+#include <stdexcept>
+
+namespace {
+
+// Target number of stored elements handled per scheduled task
+const int kElementsPerTask = 1 << 14;
+
+// Chunks per task so each task streams roughly kElementsPerTask elements
+int chunkGrain(const SellCSigmaMatrix& A) {
+    int numChunks = std::max(1, A.getChunkCount());
+    int perChunk = std::max(1, A.getStoredElements() / numChunks);
+    return std::max(1, kElementsPerTask / perChunk);
+}
+
+// y = A * x over chunks [lo, hi); Groups AVX2 registers cover one chunk
+template <int Groups>
+void spmvChunks(const SellCSigmaMatrix& A, const double* x, double* y, int lo, int hi) {
+    const int C = Groups * 4;
+    const __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    for (int c = lo; c < hi; ++c) {
+        __m256d acc[Groups];
+        for (int g = 0; g < Groups; ++g) {
+            acc[g] = _mm256_setzero_pd();
+        }
+
+        const int* idx = &A.colIndices[A.chunkPtr[c]];
+        const double* val = &A.values[A.chunkPtr[c]];
+        for (int j = 0; j < A.chunkLength[c]; ++j) {
+            for (int g = 0; g < Groups; ++g) {
+                __m128i cols = _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx + g * 4));
+                __m256d xv = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, cols, allLanes, 8);
+                acc[g] = _mm256_fmadd_pd(_mm256_loadu_pd(val + g * 4), xv, acc[g]);
+            }
+            idx += C;
+            val += C;
+        }
+
+        double out[C];
+        for (int g = 0; g < Groups; ++g) {
+            _mm256_storeu_pd(out + g * 4, acc[g]);
+        }
+        for (int r = 0; r < C; ++r) {
+            int row = A.rowPerm[c * C + r];
+            if (row >= 0) {
+                y[row] = out[r];
+            }
+        }
+    }
+}
+
+// Y = A * X over chunks [lo, hi): each chunk keeps one register per row for
+// four columns of X at a time, so Y is written once per chunk
+template <int Height>
+void spmmChunks(const SellCSigmaMatrix& A, const std::vector<const double*>& xRows,
+                const std::vector<double*>& yRows, int width, int lo, int hi) {
+    int vecWidth = width - width % 4;
+    for (int c = lo; c < hi; ++c) {
+        const int* idx = &A.colIndices[A.chunkPtr[c]];
+        const double* val = &A.values[A.chunkPtr[c]];
+        const int* perm = &A.rowPerm[c * Height];
+        int length = A.chunkLength[c];
+
+        for (int kb = 0; kb < vecWidth; kb += 4) {
+            __m256d acc[Height];
+            for (int r = 0; r < Height; ++r) {
+                acc[r] = _mm256_setzero_pd();
+            }
+            for (int j = 0; j < length; ++j) {
+                for (int r = 0; r < Height; ++r) {
+                    int pos = j * Height + r;
+                    __m256d xv = _mm256_loadu_pd(xRows[idx[pos]] + kb);
+                    acc[r] = _mm256_fmadd_pd(_mm256_set1_pd(val[pos]), xv, acc[r]);
+                }
+            }
+            for (int r = 0; r < Height; ++r) {
+                if (perm[r] >= 0) {
+                    _mm256_storeu_pd(yRows[perm[r]] + kb, acc[r]);
+                }
+            }
+        }
+
+        // Remaining columns of X that do not fill a register
+        for (int kk = vecWidth; kk < width; ++kk) {
+            for (int r = 0; r < Height; ++r) {
+                if (perm[r] < 0) {
+                    continue;
+                }
+                double sum = 0.0;
+                for (int j = 0; j < length; ++j) {
+                    int pos = j * Height + r;
+                    sum += val[pos] * xRows[idx[pos]][kk];
+                }
+                yRows[perm[r]][kk] = sum;
+            }
+        }
+    }
+}
+
+// Eight column deltas of a compressed row widened to 32 bits
+template <int Bytes>
+inline __m256i loadDeltas(const unsigned char* p);
+
+template <>
+inline __m256i loadDeltas<1>(const unsigned char* p) {
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+template <>
+inline __m256i loadDeltas<2>(const unsigned char* p) {
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+template <>
+inline __m256i loadDeltas<4>(const unsigned char* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// Columns from eight deltas: inclusive prefix sum plus the previous column
+// (broadcast in base). On return base holds the last column in every lane.
+inline __m256i decodeColumns(__m256i deltas, __m256i& base) {
+    deltas = _mm256_add_epi32(deltas, _mm256_slli_si256(deltas, 4));
+    deltas = _mm256_add_epi32(deltas, _mm256_slli_si256(deltas, 8));
+    __m256i carry = _mm256_permutevar8x32_epi32(deltas, _mm256_set1_epi32(3));
+    deltas = _mm256_add_epi32(deltas, _mm256_blend_epi32(_mm256_setzero_si256(), carry, 0xF0));
+    __m256i cols = _mm256_add_epi32(deltas, base);
+    base = _mm256_permutevar8x32_epi32(cols, _mm256_set1_epi32(7));
+    return cols;
+}
+
+// Eight values as two registers of doubles
+inline void loadValues(const double* v, __m256d& lo, __m256d& hi) {
+    lo = _mm256_loadu_pd(v);
+    hi = _mm256_loadu_pd(v + 4);
+}
+
+inline void loadValues(const float* v, __m256d& lo, __m256d& hi) {
+    __m256 packed = _mm256_loadu_ps(v);
+    lo = _mm256_cvtps_pd(_mm256_castps256_ps128(packed));
+    hi = _mm256_cvtps_pd(_mm256_extractf128_ps(packed, 1));
+}
+
+// Lanes below count (0 to 8) set, as one 32-bit mask and two 64-bit masks
+inline __m256i tailMask(int count) {
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+// First count of eight values as two registers of doubles (the rest zero)
+inline void maskLoadValues(const double* v, __m256i mask, __m256d& lo, __m256d& hi) {
+    lo = _mm256_maskload_pd(v, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(mask)));
+    hi = _mm256_maskload_pd(v + 4, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(mask, 1)));
+}
+
+inline void maskLoadValues(const float* v, __m256i mask, __m256d& lo, __m256d& hi) {
+    __m256 packed = _mm256_maskload_ps(v, mask);
+    lo = _mm256_cvtps_pd(_mm256_castps256_ps128(packed));
+    hi = _mm256_cvtps_pd(_mm256_extractf128_ps(packed, 1));
+}
+
+// Dot product of a compressed row with x, decoding in the multiply loop. The
+// last partial group decodes eight deltas anyway (indexData is padded) and
+// masks the lanes past the end of the row.
+template <typename Value, int Bytes>
+double compressedRowDot(const CompressedCSRMatrix& A, const Value* values, int row, const double* x) {
+    int begin = A.rowPtr[row];
+    int length = A.rowPtr[row + 1] - begin;
+    const unsigned char* deltas = A.indexData.data() + A.indexPtr[row];
+    const Value* val = values + begin;
+
+    const __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    __m256i base = _mm256_set1_epi32(A.firstCol[row]);
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    int j = 0;
+    for (; j + 8 <= length; j += 8) {
+        __m256i cols = decodeColumns(loadDeltas<Bytes>(deltas + j * Bytes), base);
+        __m256d x0 = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, _mm256_castsi256_si128(cols), allLanes, 8);
+        __m256d x1 = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, _mm256_extracti128_si256(cols, 1), allLanes, 8);
+        __m256d v0;
+        __m256d v1;
+        loadValues(val + j, v0, v1);
+        acc0 = _mm256_fmadd_pd(v0, x0, acc0);
+        acc1 = _mm256_fmadd_pd(v1, x1, acc1);
+    }
+    if (j < length) {
+        __m256i mask = tailMask(length - j);
+        __m256i cols = decodeColumns(loadDeltas<Bytes>(deltas + j * Bytes), base);
+        __m256d m0 = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(mask)));
+        __m256d m1 = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm256_extracti128_si256(mask, 1)));
+        __m256d x0 = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, _mm256_castsi256_si128(cols), m0, 8);
+        __m256d x1 = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, _mm256_extracti128_si256(cols, 1), m1, 8);
+        __m256d v0;
+        __m256d v1;
+        maskLoadValues(val + j, mask, v0, v1);
+        acc0 = _mm256_fmadd_pd(v0, x0, acc0);
+        acc1 = _mm256_fmadd_pd(v1, x1, acc1);
+    }
+
+    __m256d sum = _mm256_add_pd(acc0, acc1);
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+}
+
+// Columns of a compressed row, written to out (which has room for the row
+// rounded up to a multiple of eight)
+template <int Bytes>
+void decodeRow(const CompressedCSRMatrix& A, int row, int* out) {
+    int length = A.rowPtr[row + 1] - A.rowPtr[row];
+    const unsigned char* deltas = A.indexData.data() + A.indexPtr[row];
+    __m256i base = _mm256_set1_epi32(A.firstCol[row]);
+    for (int j = 0; j < length; j += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + j),
+                            decodeColumns(loadDeltas<Bytes>(deltas + j * Bytes), base));
+    }
+}
+
+// y = A * x over rows [lo, hi)
+template <typename Value>
+void compressedSpMVRows(const CompressedCSRMatrix& A, const Value* values, const double* x, double* y,
+                        int lo, int hi) {
+    for (int i = lo; i < hi; ++i) {
+        switch (A.indexBytes[i]) {
+        case 1:
+            y[i] = compressedRowDot<Value, 1>(A, values, i, x);
+            break;
+        case 2:
+            y[i] = compressedRowDot<Value, 2>(A, values, i, x);
+            break;
+        default:
+            y[i] = compressedRowDot<Value, 4>(A, values, i, x);
+            break;
+        }
+    }
+}
+
+// Y = A * X over rows [lo, hi): four registers of columns of X at a time,
+// then single registers, then the remaining columns
+template <typename Value>
+void compressedSpMMRows(const CompressedCSRMatrix& A, const Value* values, const std::vector<const double*>& xRows,
+                        Matrix& Y, int lo, int hi) {
+    static thread_local std::vector<int> cols;
+    int width = Y.getCols();
+    for (int i = lo; i < hi; ++i) {
+        int length = A.rowPtr[i + 1] - A.rowPtr[i];
+        if (static_cast<int>(cols.size()) < length + 8) {
+            cols.resize(length + 8);
+        }
+        switch (A.indexBytes[i]) {
+        case 1:
+            decodeRow<1>(A, i, cols.data());
+            break;
+        case 2:
+            decodeRow<2>(A, i, cols.data());
+            break;
+        default:
+            decodeRow<4>(A, i, cols.data());
+            break;
+        }
+
+        const Value* val = values + A.rowPtr[i];
+        double* y = Y.rowData(i);
+        int kb = 0;
+        for (; kb + 16 <= width; kb += 16) {
+            __m256d acc0 = _mm256_setzero_pd();
+            __m256d acc1 = _mm256_setzero_pd();
+            __m256d acc2 = _mm256_setzero_pd();
+            __m256d acc3 = _mm256_setzero_pd();
+            for (int j = 0; j < length; ++j) {
+                __m256d a = _mm256_set1_pd(static_cast<double>(val[j]));
+                const double* xr = xRows[cols[j]] + kb;
+                acc0 = _mm256_fmadd_pd(a, _mm256_loadu_pd(xr), acc0);
+                acc1 = _mm256_fmadd_pd(a, _mm256_loadu_pd(xr + 4), acc1);
+                acc2 = _mm256_fmadd_pd(a, _mm256_loadu_pd(xr + 8), acc2);
+                acc3 = _mm256_fmadd_pd(a, _mm256_loadu_pd(xr + 12), acc3);
+            }
+            _mm256_storeu_pd(y + kb, acc0);
+            _mm256_storeu_pd(y + kb + 4, acc1);
+            _mm256_storeu_pd(y + kb + 8, acc2);
+            _mm256_storeu_pd(y + kb + 12, acc3);
+        }
+        for (; kb + 4 <= width; kb += 4) {
+            __m256d acc = _mm256_setzero_pd();
+            for (int j = 0; j < length; ++j) {
+                acc = _mm256_fmadd_pd(_mm256_set1_pd(static_cast<double>(val[j])),
+                                      _mm256_loadu_pd(xRows[cols[j]] + kb), acc);
+            }
+            _mm256_storeu_pd(y + kb, acc);
+        }
+        for (; kb < width; ++kb) {
+            double sum = 0.0;
+            for (int j = 0; j < length; ++j) {
+                sum += static_cast<double>(val[j]) * xRows[cols[j]][kb];
+            }
+            y[kb] = sum;
+        }
+    }
+}
+
+// Rows per task so each task streams roughly kElementsPerTask elements
+int rowGrain(const CompressedCSRMatrix& A) {
+    int perRow = std::max(1, A.getNonZeros() / std::max(1, A.getRows()));
+    return std::max(1, kElementsPerTask / perRow);
+}
+
+} // namespace
+
+// Sparse matrix - dense vector multiplication using AVX2 gathers
+void sellSpMV(const SellCSigmaMatrix& A, const std::vector<double>& x, std::vector<double>& y) {
+    if (static_cast<int>(x.size()) != A.getCols()) {
+        throw std::invalid_argument("Vector length does not match matrix columns.");
+    }
+    y.assign(A.getRows(), 0.0);
+
+    const double* xp = x.data();
+    double* yp = y.data();
+    int height = A.getChunkHeight();
+    sharedThreadPool().parallelFor(0, A.getChunkCount(), chunkGrain(A), [&](int lo, int hi) {
+        if (height == 4) {
+            spmvChunks<1>(A, xp, yp, lo, hi);
+        } else if (height == 8) {
+            spmvChunks<2>(A, xp, yp, lo, hi);
+        } else {
+            spmvChunks<4>(A, xp, yp, lo, hi);
+        }
+    });
+}
+
+// Sparse matrix - dense multi-vector multiplication using AVX2
+Matrix sellSpMM(const SellCSigmaMatrix& A, const Matrix& X) {
+    if (A.getCols() != X.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
+    int width = X.getCols();
+    Matrix result(A.getRows(), width);
+
+    std::vector<const double*> xRows(X.getRows());
+    for (int i = 0; i < X.getRows(); ++i) {
+        xRows[i] = X.rowData(i);
+    }
+    std::vector<double*> yRows(A.getRows());
+    for (int i = 0; i < A.getRows(); ++i) {
+        yRows[i] = result.rowData(i);
+    }
+
+    int height = A.getChunkHeight();
+    sharedThreadPool().parallelFor(0, A.getChunkCount(), chunkGrain(A), [&](int lo, int hi) {
+        if (height == 4) {
+            spmmChunks<4>(A, xRows, yRows, width, lo, hi);
+        } else if (height == 8) {
+            spmmChunks<8>(A, xRows, yRows, width, lo, hi);
+        } else {
+            spmmChunks<16>(A, xRows, yRows, width, lo, hi);
+        }
+    });
+
+    return result;
+}
+
+// Sparse matrix - dense vector multiplication on compressed CSR
+void compressedSpMV(const CompressedCSRMatrix& A, const std::vector<double>& x, std::vector<double>& y) {
+    if (static_cast<int>(x.size()) != A.getCols()) {
+        throw std::invalid_argument("Vector length does not match matrix columns.");
+    }
+    y.assign(A.getRows(), 0.0);
+
+    const double* xp = x.data();
+    double* yp = y.data();
+    sharedThreadPool().parallelFor(0, A.getRows(), rowGrain(A), [&](int lo, int hi) {
+        if (A.getPrecision() == ValuePrecision::Float) {
+            compressedSpMVRows(A, A.floatValues.data(), xp, yp, lo, hi);
+        } else {
+            compressedSpMVRows(A, A.values.data(), xp, yp, lo, hi);
+        }
+    });
+}
+
+// Sparse matrix - dense multi-vector multiplication on compressed CSR
+Matrix compressedSpMM(const CompressedCSRMatrix& A, const Matrix& X) {
+    if (A.getCols() != X.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
+    Matrix result(A.getRows(), X.getCols());
+    std::vector<const double*> xRows(X.getRows());
+    for (int i = 0; i < X.getRows(); ++i) {
+        xRows[i] = X.rowData(i);
+    }
+
+    sharedThreadPool().parallelFor(0, A.getRows(), rowGrain(A), [&](int lo, int hi) {
+        if (A.getPrecision() == ValuePrecision::Float) {
+            compressedSpMMRows(A, A.floatValues.data(), xRows, result, lo, hi);
+        } else {
+            compressedSpMMRows(A, A.values.data(), xRows, result, lo, hi);
+        }
+    });
+
+    return result;
+}
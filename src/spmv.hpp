@@ -0,0 +1,26 @@
+#ifndef SPMV_HPP
+#define SPMV_HPP
+
+#include "compressed_csr.hpp"
+#include "matrix.hpp"
+#include "sell_matrix.hpp"
+#include <vector>
+
+// Sparse matrix - dense vector multiplication (y = A * x) using AVX2 gathers.
+// y is resized to A's row count; reusing it across calls avoids reallocation
+// in iterative solvers that apply the same A repeatedly.
+void sellSpMV(const SellCSigmaMatrix& A, const std::vector<double>& x, std::vector<double>& y);
+
+// Sparse matrix - dense multi-vector multiplication (Y = A * X) using AVX2
+Matrix sellSpMM(const SellCSigmaMatrix& A, const Matrix& X);
+
+// Sparse matrix - dense vector multiplication on compressed CSR. Eight column
+// deltas at a time are widened and prefix-summed in a register that feeds the
+// gathers directly; float values are widened and accumulated in double.
+void compressedSpMV(const CompressedCSRMatrix& A, const std::vector<double>& x, std::vector<double>& y);
+
+// Sparse matrix - dense multi-vector multiplication on compressed CSR: each
+// row's columns are decoded once, then reused for every register of columns of X
+Matrix compressedSpMM(const CompressedCSRMatrix& A, const Matrix& X);
+
+#endif // SPMV_HPP
@@ -0,0 +1,353 @@
+#include "summa.hpp"
+#include "combined_multiply.hpp"
+#include "packed_matrix.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Rows of the local C block updated per task (a multiple of the A panel height)
+const int kRowBlock = 64;
+const int kMicroRows = PackedMatrix::kPanelRows;
+const int kMicroCols = PackedMatrix::kPanelCols;
+
+typedef std::chrono::steady_clock Clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// First index of block b when total indices are split into parts even blocks
+int blockStart(int b, int total, int parts) {
+    return static_cast<int>(static_cast<long long>(total) * b / parts);
+}
+
+// Block holding index (0 <= index < total)
+int blockOwner(int index, int total, int parts) {
+    int b = static_cast<int>(static_cast<long long>(index) * parts / total);
+    while (b + 1 < parts && blockStart(b + 1, total, parts) <= index) {
+        ++b;
+    }
+    while (b > 0 && blockStart(b, total, parts) > index) {
+        --b;
+    }
+    return b;
+}
+
+// Per-rank figures sent to rank 0 with the C block
+struct RankFigures {
+    double commSeconds;
+    double computeSeconds;
+    double bytesSent;
+};
+
+} // namespace
+
+// Default options: 2 x 2 grid, 256-wide panels, one thread per process, shared memory
+SummaOptions::SummaOptions()
+    : gridRows(2), gridCols(2), panelWidth(256), threadsPerProcess(1), transport(SummaTransport::SharedMemory) {}
+
+// Report as a single human-readable line
+std::string SummaReport::toString() const {
+    std::ostringstream out;
+    out << processes << " processes, total " << totalSeconds << " s, communication "
+        << meanCommSeconds << " s mean / " << maxCommSeconds << " s max, compute "
+        << meanComputeSeconds << " s mean / " << maxComputeSeconds << " s max, "
+        << bytesSent / (1024.0 * 1024.0) << " MB sent";
+    return out.str();
+}
+
+// One rank of a SUMMA multiply
+Matrix summaMultiplyRank(Transport& transport, const MatrixView& A, const MatrixView& B,
+                         const SummaOptions& options, SummaReport* report) {
+    Clock::time_point start = Clock::now();
+    int gridRows = options.gridRows;
+    int gridCols = options.gridCols;
+    if (gridRows < 1 || gridCols < 1 || transport.size() != gridRows * gridCols) {
+        throw std::invalid_argument("Process grid does not match the transport.");
+    }
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
+    int m = A.getRows();
+    int k = A.getCols();
+    int n = B.getCols();
+    int myRow = transport.rank() / gridCols;
+    int myCol = transport.rank() % gridCols;
+    int i0 = blockStart(myRow, m, gridRows);
+    int height = blockStart(myRow + 1, m, gridRows) - i0;
+    int j0 = blockStart(myCol, n, gridCols);
+    int width = blockStart(myCol + 1, n, gridCols) - j0;
+
+    std::vector<int> rowGroup;
+    std::vector<int> colGroup;
+    for (int c = 0; c < gridCols; ++c) {
+        rowGroup.push_back(myRow * gridCols + c);
+    }
+    for (int r = 0; r < gridRows; ++r) {
+        colGroup.push_back(r * gridCols + myCol);
+    }
+
+    std::unique_ptr<ThreadPool> pool;
+    if (options.threadsPerProcess > 1) {
+        pool.reset(new ThreadPool(options.threadsPerProcess - 1)); // The calling thread takes part
+    }
+
+    // A is split into column blocks over the process columns and B into row
+    // blocks over the process rows; panels never straddle either split. The
+    // owners pack their panels in the micro-kernel layout before broadcasting
+    // them, so every panel is packed once per step
+    std::vector<double> cBlock(static_cast<size_t>(height) * width, 0.0);
+    std::vector<double> aPanel;
+    std::vector<double> bPanel;
+    double commSeconds = 0.0;
+    double computeSeconds = 0.0;
+    int panelWidth = std::max(1, options.panelWidth);
+    for (int p = 0; p < k;) {
+        int ownerCol = blockOwner(p, k, gridCols);
+        int ownerRow = blockOwner(p, k, gridRows);
+        int end = std::min(std::min(p + panelWidth, blockStart(ownerCol + 1, k, gridCols)),
+                           blockStart(ownerRow + 1, k, gridRows));
+        int depth = end - p;
+
+        Clock::time_point commStart = Clock::now();
+        if (myCol == ownerCol) {
+            packLeftPanels(A, i0, height, p, depth, aPanel);
+        } else {
+            aPanel.resize(static_cast<size_t>((height + kMicroRows - 1) / kMicroRows) * kMicroRows * depth);
+        }
+        transport.broadcast(rowGroup, myRow * gridCols + ownerCol, aPanel.data(), aPanel.size() * sizeof(double));
+        if (myRow == ownerRow) {
+            packRightPanels(B, p, depth, j0, width, bPanel);
+        } else {
+            bPanel.resize(static_cast<size_t>((width + kMicroCols - 1) / kMicroCols) * kMicroCols * depth);
+        }
+        transport.broadcast(colGroup, ownerRow * gridCols + myCol, bPanel.data(), bPanel.size() * sizeof(double));
+        commSeconds += secondsSince(commStart);
+
+        Clock::time_point computeStart = Clock::now();
+        if (height > 0 && width > 0) {
+            auto update = [&](int lo, int hi) {
+                for (int block = lo; block < hi; ++block) {
+                    int r0 = block * kRowBlock;
+                    int r1 = std::min(r0 + kRowBlock, height);
+                    // Each B micro-panel stays in L1 while it meets the block's A panels
+                    for (int jr = 0; jr < width; jr += kMicroCols) {
+                        const double* panelB = &bPanel[static_cast<size_t>(jr / kMicroCols) * kMicroCols * depth];
+                        int cols = std::min(kMicroCols, width - jr);
+                        for (int ir = r0; ir < r1; ir += kMicroRows) {
+                            const double* panelA = &aPanel[static_cast<size_t>(ir / kMicroRows) * kMicroRows * depth];
+                            simd_gemm_packed_ab(std::min(kMicroRows, r1 - ir), cols, depth, panelA, panelB,
+                                                cBlock.data() + static_cast<size_t>(ir) * width + jr, width);
+                        }
+                    }
+                }
+            };
+            int blocks = (height + kRowBlock - 1) / kRowBlock;
+            if (pool) {
+                pool->parallelFor(0, blocks, 1, update);
+            } else {
+                update(0, blocks);
+            }
+        }
+        computeSeconds += secondsSince(computeStart);
+        p = end;
+    }
+
+    // Gather the C blocks and the figures on rank 0
+    if (transport.rank() != 0) {
+        RankFigures figures = {commSeconds, computeSeconds,
+                               static_cast<double>(transport.bytesSent() + sizeof(RankFigures) +
+                                                   cBlock.size() * sizeof(double))};
+        transport.send(0, &figures, sizeof(figures));
+        transport.send(0, cBlock.data(), cBlock.size() * sizeof(double));
+        return Matrix(0, 0);
+    }
+
+    Matrix result(m, n);
+    SummaReport summary;
+    summary.processes = transport.size();
+    summary.maxCommSeconds = commSeconds;
+    summary.maxComputeSeconds = computeSeconds;
+    summary.meanCommSeconds = commSeconds;
+    summary.meanComputeSeconds = computeSeconds;
+    summary.bytesSent = transport.bytesSent();
+    std::vector<double> block;
+    for (int rank = 0; rank < transport.size(); ++rank) {
+        int r = rank / gridCols;
+        int c = rank % gridCols;
+        int rowBegin = blockStart(r, m, gridRows);
+        int rows = blockStart(r + 1, m, gridRows) - rowBegin;
+        int colBegin = blockStart(c, n, gridCols);
+        int cols = blockStart(c + 1, n, gridCols) - colBegin;
+        if (rank == 0) {
+            block.swap(cBlock);
+        } else {
+            RankFigures figures;
+            transport.receive(rank, &figures, sizeof(figures));
+            summary.maxCommSeconds = std::max(summary.maxCommSeconds, figures.commSeconds);
+            summary.maxComputeSeconds = std::max(summary.maxComputeSeconds, figures.computeSeconds);
+            summary.meanCommSeconds += figures.commSeconds;
+            summary.meanComputeSeconds += figures.computeSeconds;
+            summary.bytesSent += static_cast<long long>(figures.bytesSent);
+            block.resize(static_cast<size_t>(rows) * cols);
+            transport.receive(rank, block.data(), block.size() * sizeof(double));
+        }
+        for (int i = 0; i < rows; ++i) {
+            std::copy(block.begin() + static_cast<size_t>(i) * cols, block.begin() + static_cast<size_t>(i + 1) * cols,
+                      result.rowData(rowBegin + i) + colBegin);
+        }
+    }
+    summary.meanCommSeconds /= summary.processes;
+    summary.meanComputeSeconds /= summary.processes;
+    summary.totalSeconds = secondsSince(start);
+    if (report != nullptr) {
+        *report = summary;
+    }
+    return result;
+}
+
+// SUMMA over forked processes of this host
+Matrix summaMultiply(const Matrix& A, const Matrix& B, const SummaOptions& options, SummaReport* report) {
+    Clock::time_point start = Clock::now();
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+    if (options.gridRows < 1 || options.gridCols < 1) {
+        throw std::invalid_argument("Process grid must have at least one row and column.");
+    }
+
+    int processes = options.gridRows * options.gridCols;
+    std::unique_ptr<LocalTransport> transport;
+    if (options.transport == SummaTransport::UnixSocket) {
+        transport.reset(new UnixSocketTransport(processes));
+    } else {
+        transport.reset(new SharedMemoryTransport(processes));
+    }
+
+    std::cout.flush(); // Children must not inherit unwritten output
+    std::vector<pid_t> children;
+    auto stopChildren = [&]() {
+        transport->abort();
+        for (pid_t child : children) {
+            kill(child, SIGTERM);
+            waitpid(child, nullptr, 0);
+        }
+    };
+
+    for (int rank = 1; rank < processes; ++rank) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            stopChildren();
+            throw std::runtime_error("Could not start a SUMMA worker process.");
+        }
+        if (pid == 0) {
+            // Worker: leave through _exit so the parent's exit handlers do not run
+            int code = 0;
+            try {
+                transport->setRank(rank);
+                summaMultiplyRank(*transport, A, B, options);
+            } catch (...) {
+                transport->abort();
+                code = 1;
+            }
+            _exit(code);
+        }
+        children.push_back(pid);
+    }
+
+    Matrix result(0, 0);
+    try {
+        transport->setRank(0);
+        result = summaMultiplyRank(*transport, A, B, options, report);
+    } catch (...) {
+        stopChildren();
+        throw;
+    }
+
+    bool failed = false;
+    for (pid_t child : children) {
+        int status = 0;
+        if (waitpid(child, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        throw std::runtime_error("A SUMMA worker process failed.");
+    }
+    if (report != nullptr) {
+        report->totalSeconds = secondsSince(start);
+    }
+    return result;
+}
+
+// Multiply random matrices with SUMMA and compare with one process
+int runSummaBenchmark(int argc, char* argv[]) {
+    int size = 2000;
+    SummaOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) {
+            size = std::atoi(argv[++i]);
+        } else if (arg == "--grid" && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%dx%d", &options.gridRows, &options.gridCols) != 2) {
+                options.gridRows = 0;
+            }
+        } else if (arg == "--panel" && i + 1 < argc) {
+            options.panelWidth = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threadsPerProcess = std::atoi(argv[++i]);
+        } else if (arg == "--transport" && i + 1 < argc) {
+            std::string kind = argv[++i];
+            options.transport = kind == "socket" ? SummaTransport::UnixSocket : SummaTransport::SharedMemory;
+        }
+    }
+    if (size < 1 || options.gridRows < 1 || options.gridCols < 1) {
+        std::cerr << "Usage: " << argv[0]
+                  << " --summa [--size N] [--grid RxC] [--panel W] [--threads T]"
+                  << " [--transport shm|socket]" << std::endl;
+        return 1;
+    }
+
+    try {
+        Matrix A(size, size);
+        Matrix B(size, size);
+        A.fillRandom(0.0);
+        B.fillRandom(0.0);
+
+        SummaReport report;
+        Matrix distributed = summaMultiply(A, B, options, &report);
+        std::cout << "SUMMA " << options.gridRows << "x" << options.gridCols << ": " << report.toString() << std::endl;
+
+        Clock::time_point start = Clock::now();
+        Matrix local = combinedDenseMultiply(A, B);
+        std::cout << "Single process (combined engine): " << secondsSince(start) << " s" << std::endl;
+
+        double worst = 0.0;
+        for (int i = 0; i < size; ++i) {
+            for (int j = 0; j < size; ++j) {
+                worst = std::max(worst, std::fabs(distributed.rowData(i)[j] - local.rowData(i)[j]));
+            }
+        }
+        std::cout << "Max difference: " << worst << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+#ifndef SUMMA_HPP
+#define SUMMA_HPP
+
+#include "matrix.hpp"
+#include "transport.hpp"
+#include <string>
+
+// Local transport used by summaMultiply
+enum class SummaTransport {
+    SharedMemory, // Ring buffers in a shared mapping
+    UnixSocket    // AF_UNIX socket pairs
+};
+
+// Configuration of a distributed multiply
+struct SummaOptions {
+    SummaOptions();
+
+    int gridRows;             // The process grid is gridRows x gridCols
+    int gridCols;
+    int panelWidth;           // Columns of A (rows of B) broadcast per step
+    int threadsPerProcess;    // Threads running the local update in each process
+    SummaTransport transport; // Used by summaMultiply only
+};
+
+// Communication versus compute time of a distributed multiply
+struct SummaReport {
+    int processes;
+    double totalSeconds;       // Wall time on rank 0, from start-up to the gathered result
+    double maxCommSeconds;     // Slowest rank's time in panel broadcasts (waiting included)
+    double maxComputeSeconds;  // Slowest rank's time in local updates
+    double meanCommSeconds;
+    double meanComputeSeconds;
+    long long bytesSent;       // Over all ranks, gathering the result included
+
+    // Report as a single human-readable line
+    std::string toString() const;
+};
+
+// One rank of a SUMMA multiply on a gridRows x gridCols process grid, with
+// rank = row * gridCols + col. Rank (r, c) owns block (r, c) of A, B and C
+// under an even block split. Each step, the owners broadcast a panel of A
+// along their process row and a panel of B along their process column, and
+// every rank adds the panel product to its C block with the packed SIMD
+// micro-kernel (the owners pack the panels before sending them). Only the
+// rank's own blocks of A and B are read. The C blocks are gathered on rank 0,
+// which returns the product (and fills report); other ranks return an empty
+// matrix.
+Matrix summaMultiplyRank(Transport& transport, const MatrixView& A, const MatrixView& B,
+                         const SummaOptions& options, SummaReport* report = nullptr);
+
+// A * B with SUMMA over gridRows * gridCols processes of this host: the
+// calling process is rank 0, the others are forked and inherit the operands
+Matrix summaMultiply(const Matrix& A, const Matrix& B, const SummaOptions& options = SummaOptions(),
+                     SummaReport* report = nullptr);
+
+// Multiply random matrices with summaMultiply from command-line options
+// (--size N, --grid RxC, --panel W, --threads T, --transport shm|socket) and
+// print the report; returns an exit code
+int runSummaBenchmark(int argc, char* argv[]);
+
+#endif // SUMMA_HPP
@@ -0,0 +1,150 @@
+#include "thread_pool.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+// Constructor
+ThreadPool::ThreadPool(int numThreads) : stopping(false) {
+    if (numThreads <= 0) {
+        numThreads = static_cast<int>(std::thread::hardware_concurrency());
+        if (numThreads <= 0) {
+            numThreads = 1; // hardware_concurrency may report 0 when unknown
+        }
+    }
+    for (int i = 0; i < numThreads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+// Destructor: finish queued tasks, then join the workers
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+    for (auto& t : workers) {
+        t.join();
+    }
+}
+
+// Queue a task for any worker
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        tasks.push(std::move(task));
+    }
+    queueCondition.notify_one();
+}
+
+// Get number of worker threads
+int ThreadPool::getThreadCount() const {
+    return static_cast<int>(workers.size());
+}
+
+// Worker main loop: pop and run tasks until the pool is stopped
+void ThreadPool::workerLoop(int index) {
+#ifdef MATRIX_TRACE
+    traceSetThreadName("pool worker " + std::to_string(index));
+#else
+    (void)index;
+#endif
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
+
+namespace {
+
+// State shared between the caller of parallelFor and its helper tasks. It is
+// reference counted because helpers may start after the loop has finished.
+struct ParallelForState {
+    std::atomic<int> next;
+    std::atomic<int> remaining;
+    int end;
+    int grain;
+    const std::function<void(int, int)>* body;
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+    std::exception_ptr error;
+};
+
+// Claim and run chunks until none are left
+void runChunks(const std::shared_ptr<ParallelForState>& state) {
+    for (;;) {
+        int lo = state->next.fetch_add(state->grain);
+        if (lo >= state->end) {
+            return;
+        }
+        int hi = std::min(lo + state->grain, state->end);
+        try {
+            TRACE_SCOPE_ARG("chunk", lo);
+            (*state->body)(lo, hi);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state->doneMutex);
+            if (!state->error) {
+                state->error = std::current_exception();
+            }
+        }
+        if (state->remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(state->doneMutex);
+            state->doneCondition.notify_all();
+        }
+    }
+}
+
+} // namespace
+
+// Run body over [begin, end) in dynamically scheduled chunks
+void ThreadPool::parallelFor(int begin, int end, int grain,
+                             const std::function<void(int, int)>& body) {
+    if (end <= begin) {
+        return;
+    }
+    if (grain < 1) {
+        grain = 1;
+    }
+
+    int chunks = (end - begin + grain - 1) / grain;
+    if (chunks == 1 || workers.empty()) {
+        body(begin, end);
+        return;
+    }
+
+    std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>();
+    state->next = begin;
+    state->remaining = chunks;
+    state->end = end;
+    state->grain = grain;
+    state->body = &body;
+
+    int helpers = std::min(chunks - 1, getThreadCount());
+    for (int i = 0; i < helpers; ++i) {
+        submit([state] { runChunks(state); });
+    }
+    runChunks(state);
+
+    std::unique_lock<std::mutex> lock(state->doneMutex);
+    state->doneCondition.wait(lock, [&state] { return state->remaining.load() == 0; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+// Process-wide pool used by the threaded engines
+ThreadPool& sharedThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
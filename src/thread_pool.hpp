@@ -0,0 +1,48 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads shared by the parallel engines, so that kernels
+// stop paying thread creation and joining on every multiply.
+class ThreadPool {
+public:
+    // Constructor (numThreads <= 0 uses the hardware concurrency)
+    explicit ThreadPool(int numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task for any worker
+    void submit(std::function<void()> task);
+
+    // Run body(lo, hi) over [begin, end) in chunks of at most grain indices.
+    // Chunks are handed out dynamically and the calling thread takes part, so
+    // nested calls from inside a worker cannot deadlock. The first exception
+    // thrown by body is rethrown here once every chunk has finished.
+    void parallelFor(int begin, int end, int grain,
+                     const std::function<void(int, int)>& body);
+
+    // Number of worker threads
+    int getThreadCount() const;
+
+private:
+    void workerLoop(int index);
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    bool stopping;
+};
+
+// Process-wide pool used by the threaded engines
+ThreadPool& sharedThreadPool();
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,56 @@
+#include "tile_map.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+// Constructor: count the non-zero elements of every tile of M
+TileMap::TileMap(const Matrix& M, int tileSize, double zero)
+    : rows(M.getRows()), cols(M.getCols()), tileSize(tileSize) {
+    if (tileSize < 1) {
+        throw std::invalid_argument("Tile size must be positive.");
+    }
+    tileRows = (rows + tileSize - 1) / tileSize;
+    tileCols = (cols + tileSize - 1) / tileSize;
+    counts.assign(static_cast<size_t>(tileRows) * tileCols, 0);
+
+    for (int i = 0; i < rows; ++i) {
+        const double* row = M.rowData(i);
+        int* tileCounts = &counts[static_cast<size_t>(i / tileSize) * tileCols];
+        for (int j = 0; j < cols; ++j) {
+            if (row[j] != zero) {
+                ++tileCounts[j / tileSize];
+            }
+        }
+    }
+}
+
+// Get the tile edge length
+int TileMap::getTileSize() const {
+    return tileSize;
+}
+
+// Get number of tile rows
+int TileMap::getTileRows() const {
+    return tileRows;
+}
+
+// Get number of tile columns
+int TileMap::getTileCols() const {
+    return tileCols;
+}
+
+// Number of non-zero elements in tile (ti, tj)
+int TileMap::nonZeros(int ti, int tj) const {
+    return counts[static_cast<size_t>(ti) * tileCols + tj];
+}
+
+// True when tile (ti, tj) holds no non-zero element
+bool TileMap::isEmpty(int ti, int tj) const {
+    return nonZeros(ti, tj) == 0;
+}
+
+// Fraction of non-zero elements in tile (ti, tj)
+double TileMap::density(int ti, int tj) const {
+    int height = std::min(tileSize, rows - ti * tileSize);
+    int width = std::min(tileSize, cols - tj * tileSize);
+    return static_cast<double>(nonZeros(ti, tj)) / (static_cast<double>(height) * width);
+}
@@ -0,0 +1,43 @@
+#ifndef TILE_MAP_HPP
+#define TILE_MAP_HPP
+
+#include "matrix.hpp"
+#include <vector>
+
+// Per-tile occupancy of a matrix cut into tileSize x tileSize tiles
+// (edge tiles are smaller). Blocked kernels use it to skip empty tiles and to
+// choose between a sparse and a dense inner kernel.
+class TileMap {
+public:
+    // Constructor: count the non-zero elements of every tile of M, where zero
+    // names the value that counts as empty (a semiring's zero)
+    TileMap(const Matrix& M, int tileSize, double zero = 0.0);
+
+    // Get the tile edge length
+    int getTileSize() const;
+
+    // Get number of tile rows
+    int getTileRows() const;
+
+    // Get number of tile columns
+    int getTileCols() const;
+
+    // Number of non-zero elements in tile (ti, tj)
+    int nonZeros(int ti, int tj) const;
+
+    // True when tile (ti, tj) holds no non-zero element
+    bool isEmpty(int ti, int tj) const;
+
+    // Fraction of non-zero elements in tile (ti, tj)
+    double density(int ti, int tj) const;
+
+private:
+    int rows;
+    int cols;
+    int tileSize;
+    int tileRows;
+    int tileCols;
+    std::vector<int> counts; // Non-zero count of each tile, row-major
+};
+
+#endif // TILE_MAP_HPP
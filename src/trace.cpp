@@ -0,0 +1,273 @@
+#include "trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Events kept per thread (the newest ones win). The ring is allocated in
+// chunks on first use, so a thread that records a handful of events costs a
+// few kilobytes rather than the whole ring.
+const size_t kChunkEvents = 128;
+const size_t kChunkCount = 512;
+const size_t kRingCapacity = kChunkEvents * kChunkCount;
+
+struct TraceEvent {
+    const char* name;
+    int64_t arg;
+    bool hasArg;
+    uint64_t beginNs;
+    uint64_t endNs;
+};
+
+// Single-writer ring: only the owning thread allocates chunks, writes events
+// and advances head; readers take head with acquire ordering (every slot
+// below it has its chunk) and discard slots that may have been overwritten
+// while they were reading. traceReset never touches head: it raises
+// resetAt, and readers skip the events below it.
+struct ThreadBuffer {
+    ThreadBuffer() : head(0), resetAt(0), exited(false), threadId(0) {
+        for (size_t c = 0; c < kChunkCount; ++c) {
+            chunks[c].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~ThreadBuffer() {
+        for (size_t c = 0; c < kChunkCount; ++c) {
+            delete[] chunks[c].load(std::memory_order_relaxed);
+        }
+    }
+
+    // Slot of event number position, allocating its chunk when needed (owner only)
+    TraceEvent& slotForWrite(uint64_t position) {
+        size_t index = static_cast<size_t>(position % kRingCapacity);
+        std::atomic<TraceEvent*>& chunk = chunks[index / kChunkEvents];
+        TraceEvent* events = chunk.load(std::memory_order_relaxed);
+        if (events == nullptr) {
+            events = new TraceEvent[kChunkEvents];
+            chunk.store(events, std::memory_order_release);
+        }
+        return events[index % kChunkEvents];
+    }
+
+    // Slot of event number position, which must be below head
+    const TraceEvent& slot(uint64_t position) const {
+        size_t index = static_cast<size_t>(position % kRingCapacity);
+        return chunks[index / kChunkEvents].load(std::memory_order_acquire)[index % kChunkEvents];
+    }
+
+    std::atomic<TraceEvent*> chunks[kChunkCount];
+    std::atomic<uint64_t> head;    // Number of events ever written
+    std::atomic<uint64_t> resetAt; // Events below this position were reset
+    std::atomic<bool> exited;      // The owning thread has finished
+    int threadId;
+    std::string threadName;
+};
+
+// Per-thread handle: marks the buffer as exited when the thread ends, so the
+// registry can drop it once its events have been written or reset
+struct ThreadHandle {
+    std::shared_ptr<ThreadBuffer> buffer;
+
+    ~ThreadHandle() {
+        if (buffer) {
+            buffer->exited.store(true, std::memory_order_release);
+        }
+    }
+};
+
+struct Registry {
+    std::mutex mutex; // Guards buffers and names; taken once per thread, not per event
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    int nextThreadId = 1;
+    std::chrono::steady_clock::time_point epoch;
+};
+
+void writeAtExit();
+
+// Created on first use and never destroyed, so it outlives the exit handler
+// and the thread_local buffer handles
+Registry* createRegistry() {
+    Registry* instance = new Registry();
+    instance->epoch = std::chrono::steady_clock::now();
+    if (std::getenv("MATRIX_TRACE_FILE") != nullptr) {
+        std::atexit(writeAtExit);
+    }
+    return instance;
+}
+
+Registry& registry() {
+    static Registry* instance = createRegistry();
+    return *instance;
+}
+
+// Buffer of the calling thread, registered on first use. The registry keeps
+// it alive after the thread exits so short-lived threads still show up, until
+// their events are written out or reset.
+ThreadBuffer& threadBuffer() {
+    thread_local ThreadHandle handle;
+    if (!handle.buffer) {
+        handle.buffer = std::make_shared<ThreadBuffer>();
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        handle.buffer->threadId = r.nextThreadId++;
+        r.buffers.push_back(handle.buffer);
+    }
+    return *handle.buffer;
+}
+
+// Drop the given buffers from the registry (registry mutex held)
+void releaseBuffers(Registry& r, const std::vector<std::shared_ptr<ThreadBuffer>>& done) {
+    r.buffers.erase(std::remove_if(r.buffers.begin(), r.buffers.end(),
+                                   [&](const std::shared_ptr<ThreadBuffer>& buffer) {
+                                       return std::find(done.begin(), done.end(), buffer) != done.end();
+                                   }),
+                    r.buffers.end());
+}
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now() - registry().epoch)
+                                     .count());
+}
+
+// Escape a name for a JSON string
+std::string jsonString(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+void writeAtExit() {
+    const char* path = std::getenv("MATRIX_TRACE_FILE");
+    if (path != nullptr) {
+        traceWriteChromeJson(path);
+    }
+}
+
+} // namespace
+
+// Constructor: remember the start time
+TraceScope::TraceScope(const char* name, int64_t arg, bool hasArg)
+    : name(name), arg(arg), hasArg(hasArg), beginNs(nowNs()) {}
+
+// Destructor: append the complete event to this thread's ring
+TraceScope::~TraceScope() {
+    ThreadBuffer& buffer = threadBuffer();
+    uint64_t position = buffer.head.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer.slotForWrite(position);
+    event.name = name;
+    event.arg = arg;
+    event.hasArg = hasArg;
+    event.beginNs = beginNs;
+    event.endNs = nowNs();
+    buffer.head.store(position + 1, std::memory_order_release);
+}
+
+// Name shown for the calling thread
+void traceSetThreadName(const std::string& name) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer.threadName = name;
+}
+
+// Write the buffered events as Chrome trace JSON (complete "X" events, times in microseconds)
+bool traceWriteChromeJson(const std::string& path) {
+    std::ofstream out(path.c_str());
+    if (!out) {
+        return false;
+    }
+
+    Registry& r = registry();
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        buffers = r.buffers;
+    }
+
+    out << std::fixed << std::setprecision(3); // Microseconds with nanosecond resolution
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    std::vector<std::shared_ptr<ThreadBuffer>> finished; // Exited before their events were read
+    for (const std::shared_ptr<ThreadBuffer>& buffer : buffers) {
+        if (buffer->exited.load(std::memory_order_acquire)) {
+            finished.push_back(buffer);
+        }
+        std::string threadName;
+        {
+            std::lock_guard<std::mutex> lock(r.mutex);
+            threadName = buffer->threadName;
+        }
+        if (threadName.empty()) {
+            threadName = "thread " + std::to_string(buffer->threadId);
+        }
+        out << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":"
+            << buffer->threadId << ",\"args\":{\"name\":" << jsonString(threadName) << "}}";
+        first = false;
+
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t begin = std::max(head > kRingCapacity ? head - kRingCapacity : 0,
+                                  buffer->resetAt.load(std::memory_order_acquire));
+        std::vector<TraceEvent> snapshot;
+        snapshot.reserve(static_cast<size_t>(head - begin));
+        for (uint64_t i = begin; i < head; ++i) {
+            snapshot.push_back(buffer->slot(i));
+        }
+        // Slots the owner may have reused while they were being copied
+        uint64_t headAfter = buffer->head.load(std::memory_order_acquire);
+        uint64_t stale = headAfter > kRingCapacity + begin ? headAfter - kRingCapacity - begin : 0;
+
+        for (size_t i = static_cast<size_t>(std::min<uint64_t>(stale, snapshot.size())); i < snapshot.size(); ++i) {
+            const TraceEvent& event = snapshot[i];
+            out << ",\n{\"ph\":\"X\",\"name\":" << jsonString(event.name) << ",\"pid\":1,\"tid\":"
+                << buffer->threadId << ",\"ts\":" << event.beginNs / 1000.0
+                << ",\"dur\":" << (event.endNs - event.beginNs) / 1000.0;
+            if (event.hasArg) {
+                out << ",\"args\":{\"value\":" << event.arg << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    if (!out) {
+        return false;
+    }
+
+    // Threads that had finished have nothing more to record
+    std::lock_guard<std::mutex> lock(r.mutex);
+    releaseBuffers(r, finished);
+    return true;
+}
+
+// Drop every buffered event. Owners keep writing undisturbed: each ring only
+// moves its floor up to the events written so far, and an event being
+// recorded meanwhile lands above it.
+void traceReset() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<std::shared_ptr<ThreadBuffer>> finished;
+    for (const std::shared_ptr<ThreadBuffer>& buffer : r.buffers) {
+        if (buffer->exited.load(std::memory_order_acquire)) {
+            finished.push_back(buffer);
+        }
+    }
+    releaseBuffers(r, finished);
+    for (const std::shared_ptr<ThreadBuffer>& buffer : r.buffers) {
+        buffer->resetAt.store(buffer->head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+}
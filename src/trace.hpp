@@ -0,0 +1,64 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cstdint>
+#include <string>
+
+// Timeline tracing of threaded kernels, compiled in only with -DMATRIX_TRACE
+// (make TRACE=1). TRACE_SCOPE("name") records the time the enclosing scope
+// took on the calling thread; TRACE_SCOPE_ARG("name", value) also records an
+// integer such as the first row of a block. Events go to a fixed-size ring
+// buffer owned by each thread, so recording takes no lock; when a buffer is
+// full the oldest events are overwritten. Rings are allocated in small chunks
+// as they fill, and the ring of a thread that has exited is freed once its
+// events have been written or reset.
+//
+// The timeline is written in Chrome trace JSON (open it in chrome://tracing
+// or ui.perfetto.dev) by traceWriteChromeJson, or at exit to the file named
+// by the MATRIX_TRACE_FILE environment variable.
+//
+// Names must be string literals (only the pointer is stored).
+
+#ifdef MATRIX_TRACE
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name, 0, false)
+#define TRACE_SCOPE_ARG(name, arg) \
+    TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name, static_cast<int64_t>(arg), true)
+
+#else
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_SCOPE_ARG(name, arg) ((void)0)
+
+#endif // MATRIX_TRACE
+
+// Records one complete event for its lifetime (use the macros above)
+class TraceScope {
+public:
+    TraceScope(const char* name, int64_t arg, bool hasArg);
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    int64_t arg;
+    bool hasArg;
+    uint64_t beginNs;
+};
+
+// Name shown for the calling thread in the timeline
+void traceSetThreadName(const std::string& name);
+
+// Write every buffered event as Chrome trace JSON; returns false if the file
+// cannot be written. Call it while traced work is idle.
+bool traceWriteChromeJson(const std::string& path);
+
+// Drop every buffered event; safe while traced work is running (events that
+// finish during the call may be kept)
+void traceReset();
+
+#endif // TRACE_HPP
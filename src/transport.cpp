@@ -0,0 +1,271 @@
+#include "transport.hpp"
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Shared state in front of the channels
+struct ControlBlock {
+    std::atomic<int> aborted;
+};
+
+const size_t kCacheLine = 64;
+
+size_t roundToCacheLine(size_t bytes) {
+    return (bytes + kCacheLine - 1) / kCacheLine * kCacheLine;
+}
+
+} // namespace
+
+// Copy data from root to the other members of group, one send per member
+void Transport::broadcast(const std::vector<int>& group, int root, void* data, size_t bytes) {
+    if (rank() != root) {
+        receive(root, data, bytes);
+        return;
+    }
+    for (int member : group) {
+        if (member != root) {
+            send(member, data, bytes);
+        }
+    }
+}
+
+// Ring buffer from one rank to another; the ring follows the header. The two
+// counters live on separate cache lines so writer and reader do not share one.
+struct SharedMemoryTransport::Channel {
+    alignas(64) std::atomic<unsigned long long> written;
+    alignas(64) std::atomic<unsigned long long> read;
+};
+
+// Constructor: map and initialize every channel (before fork)
+SharedMemoryTransport::SharedMemoryTransport(int processes, size_t channelBytes)
+    : processes(processes), myRank(-1), channelBytes(channelBytes),
+      channelStride(roundToCacheLine(sizeof(Channel) + channelBytes)), region(nullptr), regionBytes(0) {
+    if (processes < 1 || channelBytes == 0) {
+        throw std::invalid_argument("Invalid transport configuration.");
+    }
+    regionBytes = roundToCacheLine(sizeof(ControlBlock)) + channelStride * processes * processes;
+    region = mmap(nullptr, regionBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        region = nullptr;
+        throw std::runtime_error("Could not map shared memory for the transport.");
+    }
+    ControlBlock* control = new (region) ControlBlock();
+    control->aborted = 0;
+    for (int s = 0; s < processes; ++s) {
+        for (int d = 0; d < processes; ++d) {
+            if (s == d) {
+                continue;
+            }
+            Channel* ch = new (channel(s, d)) Channel();
+            ch->written = 0;
+            ch->read = 0;
+        }
+    }
+}
+
+// Destructor
+SharedMemoryTransport::~SharedMemoryTransport() {
+    if (region != nullptr) {
+        munmap(region, regionBytes);
+    }
+}
+
+int SharedMemoryTransport::rank() const {
+    return myRank;
+}
+
+int SharedMemoryTransport::size() const {
+    return processes;
+}
+
+// Copy into the ring in pieces as the reader frees space
+void SharedMemoryTransport::send(int dest, const void* data, size_t bytes) {
+    Channel* ch = channel(myRank, dest);
+    char* ring = reinterpret_cast<char*>(ch) + sizeof(Channel);
+    const char* src = static_cast<const char*>(data);
+    while (bytes > 0) {
+        unsigned long long w = ch->written.load(std::memory_order_relaxed);
+        unsigned long long r = ch->read.load(std::memory_order_acquire);
+        size_t space = channelBytes - static_cast<size_t>(w - r);
+        if (space == 0) {
+            checkAborted();
+            std::this_thread::yield();
+            continue;
+        }
+        size_t offset = static_cast<size_t>(w % channelBytes);
+        size_t count = std::min(std::min(bytes, space), channelBytes - offset);
+        std::memcpy(ring + offset, src, count);
+        ch->written.store(w + count, std::memory_order_release);
+        src += count;
+        bytes -= count;
+        sentBytes += count;
+    }
+}
+
+// Copy out of the ring in pieces as the writer fills it
+void SharedMemoryTransport::receive(int source, void* data, size_t bytes) {
+    Channel* ch = channel(source, myRank);
+    const char* ring = reinterpret_cast<const char*>(ch) + sizeof(Channel);
+    char* dst = static_cast<char*>(data);
+    while (bytes > 0) {
+        unsigned long long r = ch->read.load(std::memory_order_relaxed);
+        unsigned long long w = ch->written.load(std::memory_order_acquire);
+        size_t available = static_cast<size_t>(w - r);
+        if (available == 0) {
+            checkAborted();
+            std::this_thread::yield();
+            continue;
+        }
+        size_t offset = static_cast<size_t>(r % channelBytes);
+        size_t count = std::min(std::min(bytes, available), channelBytes - offset);
+        std::memcpy(dst, ring + offset, count);
+        ch->read.store(r + count, std::memory_order_release);
+        dst += count;
+        bytes -= count;
+    }
+}
+
+// Bind this process to rank
+void SharedMemoryTransport::setRank(int rank) {
+    if (rank < 0 || rank >= processes) {
+        throw std::invalid_argument("Transport rank out of range.");
+    }
+    myRank = rank;
+}
+
+// Wake every waiting rank with an error
+void SharedMemoryTransport::abort() {
+    static_cast<ControlBlock*>(region)->aborted = 1;
+}
+
+// Channel from source to dest
+SharedMemoryTransport::Channel* SharedMemoryTransport::channel(int source, int dest) const {
+    if (source < 0 || source >= processes || dest < 0 || dest >= processes || source == dest) {
+        throw std::invalid_argument("Transport rank out of range.");
+    }
+    char* base = static_cast<char*>(region) + roundToCacheLine(sizeof(ControlBlock));
+    return reinterpret_cast<Channel*>(base + channelStride * (static_cast<size_t>(source) * processes + dest));
+}
+
+// Throw when another rank gave up
+void SharedMemoryTransport::checkAborted() const {
+    if (static_cast<const ControlBlock*>(region)->aborted.load()) {
+        throw std::runtime_error("Another rank aborted the transport.");
+    }
+}
+
+// Constructor: connect every pair of ranks (before fork)
+UnixSocketTransport::UnixSocketTransport(int processes)
+    : processes(processes), myRank(-1),
+      fds(static_cast<size_t>(std::max(processes, 0)) * std::max(processes, 0), -1) {
+    if (processes < 1) {
+        throw std::invalid_argument("Invalid transport configuration.");
+    }
+    for (int i = 0; i < processes; ++i) {
+        for (int j = i + 1; j < processes; ++j) {
+            int pair[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+                abort();
+                throw std::runtime_error("Could not create transport sockets.");
+            }
+            fds[i * processes + j] = pair[0];
+            fds[j * processes + i] = pair[1];
+        }
+    }
+}
+
+// Destructor
+UnixSocketTransport::~UnixSocketTransport() {
+    abort();
+}
+
+int UnixSocketTransport::rank() const {
+    return myRank;
+}
+
+int UnixSocketTransport::size() const {
+    return processes;
+}
+
+// Write all bytes to dest's socket
+void UnixSocketTransport::send(int dest, const void* data, size_t bytes) {
+    if (myRank < 0 || dest < 0 || dest >= processes || dest == myRank) {
+        throw std::invalid_argument("Transport rank out of range.");
+    }
+    int fd = fds[myRank * processes + dest];
+    const char* src = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t count = ::send(fd, src, bytes, MSG_NOSIGNAL);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Transport send failed.");
+        }
+        src += count;
+        bytes -= count;
+        sentBytes += count;
+    }
+}
+
+// Read all bytes from source's socket
+void UnixSocketTransport::receive(int source, void* data, size_t bytes) {
+    if (myRank < 0 || source < 0 || source >= processes || source == myRank) {
+        throw std::invalid_argument("Transport rank out of range.");
+    }
+    int fd = fds[myRank * processes + source];
+    char* dst = static_cast<char*>(data);
+    while (bytes > 0) {
+        ssize_t count = ::recv(fd, dst, bytes, 0);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Transport receive failed.");
+        }
+        if (count == 0) {
+            throw std::runtime_error("Another rank closed the transport.");
+        }
+        dst += count;
+        bytes -= count;
+    }
+}
+
+// Bind this process to rank and close the other ranks' sockets
+void UnixSocketTransport::setRank(int rank) {
+    if (rank < 0 || rank >= processes) {
+        throw std::invalid_argument("Transport rank out of range.");
+    }
+    myRank = rank;
+    for (int i = 0; i < processes; ++i) {
+        if (i == rank) {
+            continue;
+        }
+        for (int j = 0; j < processes; ++j) {
+            int& fd = fds[i * processes + j];
+            if (fd >= 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+    }
+}
+
+// Close this rank's sockets so its peers see end of file
+void UnixSocketTransport::abort() {
+    for (int& fd : fds) {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+}
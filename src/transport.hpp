@@ -0,0 +1,99 @@
+#ifndef TRANSPORT_HPP
+#define TRANSPORT_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Point-to-point byte channels between the ranks of a distributed multiply.
+// Messages between two ranks arrive in the order they were sent. A network
+// transport only needs send() and receive(); broadcast() can be overridden
+// when the fabric offers something better than one send per member.
+class Transport {
+public:
+    virtual ~Transport() {}
+
+    // This process's rank and the number of ranks
+    virtual int rank() const = 0;
+    virtual int size() const = 0;
+
+    // Blocking send and receive of exactly bytes bytes
+    virtual void send(int dest, const void* data, size_t bytes) = 0;
+    virtual void receive(int source, void* data, size_t bytes) = 0;
+
+    // Copy bytes at data on root to data on every other rank of group (which
+    // must list root and this rank); every member calls it with the same group
+    virtual void broadcast(const std::vector<int>& group, int root, void* data, size_t bytes);
+
+    // Total bytes this rank has sent
+    long long bytesSent() const { return sentBytes; }
+
+protected:
+    long long sentBytes = 0;
+};
+
+// Transport between processes forked from one parent: the channels are set up
+// before fork() and each process then picks its rank
+class LocalTransport : public Transport {
+public:
+    // Bind this process to rank (call once, after fork)
+    virtual void setRank(int rank) = 0;
+
+    // Make ranks blocked on this one fail instead of waiting forever (called by
+    // a rank that gives up after an error)
+    virtual void abort() = 0;
+};
+
+// Single-producer ring buffers in a shared anonymous mapping, one per ordered
+// pair of ranks; waiting ranks yield the CPU
+class SharedMemoryTransport : public LocalTransport {
+public:
+    explicit SharedMemoryTransport(int processes, size_t channelBytes = size_t(1) << 20);
+    ~SharedMemoryTransport();
+
+    SharedMemoryTransport(const SharedMemoryTransport&) = delete;
+    SharedMemoryTransport& operator=(const SharedMemoryTransport&) = delete;
+
+    int rank() const;
+    int size() const;
+    void send(int dest, const void* data, size_t bytes);
+    void receive(int source, void* data, size_t bytes);
+    void setRank(int rank);
+    void abort();
+
+private:
+    struct Channel;
+
+    Channel* channel(int source, int dest) const;
+    void checkAborted() const;
+
+    int processes;
+    int myRank;
+    size_t channelBytes;
+    size_t channelStride; // Channel header plus ring, rounded to a cache line
+    void* region;
+    size_t regionBytes;
+};
+
+// Connected AF_UNIX stream socket pairs, one per pair of ranks
+class UnixSocketTransport : public LocalTransport {
+public:
+    explicit UnixSocketTransport(int processes);
+    ~UnixSocketTransport();
+
+    UnixSocketTransport(const UnixSocketTransport&) = delete;
+    UnixSocketTransport& operator=(const UnixSocketTransport&) = delete;
+
+    int rank() const;
+    int size() const;
+    void send(int dest, const void* data, size_t bytes);
+    void receive(int source, void* data, size_t bytes);
+    void setRank(int rank);
+    void abort();
+
+private:
+    int processes;
+    int myRank;
+    std::vector<int> fds; // fds[i * processes + j]: rank i's end of the i-j socket (-1 when closed)
+};
+
+#endif // TRANSPORT_HPP
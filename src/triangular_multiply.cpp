@@ -0,0 +1,244 @@
+#include "triangular_multiply.hpp"
+#include "packed_matrix.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Micro-tile of the kernel
+const int kMicroRows = PackedMatrix::kPanelRows;
+const int kMicroCols = PackedMatrix::kPanelCols;
+
+// Output tiles are kTile x kTile; depth is packed kDepth at a time
+const int kTile = 128;
+const int kDepth = 256;
+
+// Per-thread packing buffers, grown on first use and kept for later calls
+thread_local std::vector<double> packedA;
+thread_local std::vector<double> packedB;
+
+// One output tile and the depth range [p0, p1) that can contribute to it
+struct TileTask {
+    int i0;
+    int j0;
+    int p0;
+    int p1;
+    double work; // Multiply-adds, for ordering
+};
+
+// Operands of a triangular problem and which parts of them are known zero
+struct TileProblem {
+    TileProblem(const MatrixView& A, const MatrixView& B, Triangle triangle)
+        : A(A), B(B), triangle(triangle), maskA(false), maskB(false), triangleOnly(false) {}
+
+    MatrixView A;
+    MatrixView B;
+    Triangle triangle;
+    bool maskA;        // Elements of A outside the triangle are zero
+    bool maskB;        // Elements of B outside the triangle are zero
+    bool triangleOnly; // Only the triangle of the result is needed
+};
+
+// True when element (row, col) lies outside the triangle
+inline bool outside(Triangle triangle, int row, int col) {
+    return triangle == Triangle::Lower ? col > row : col < row;
+}
+
+// True when a block of rows [r0, r1) x columns [c0, c1) lies inside the triangle
+inline bool blockInside(Triangle triangle, int r0, int r1, int c0, int c1) {
+    return triangle == Triangle::Lower ? c1 - 1 <= r0 : c0 >= r1 - 1;
+}
+
+// Zero the elements outside the triangle in packed left panels of rows
+// [i0, i0 + height) x depth [p0, p0 + depth)
+void maskLeftPanels(Triangle triangle, int i0, int height, int p0, int depth) {
+    if (blockInside(triangle, i0, i0 + height, p0, p0 + depth)) {
+        return;
+    }
+    for (int r = 0; r < height; ++r) {
+        double* dst = &packedA[static_cast<size_t>(r / kMicroRows) * kMicroRows * depth + r % kMicroRows];
+        for (int q = 0; q < depth; ++q) {
+            if (outside(triangle, i0 + r, p0 + q)) {
+                dst[static_cast<size_t>(q) * kMicroRows] = 0.0;
+            }
+        }
+    }
+}
+
+// Zero the elements outside the triangle in packed right panels of depth
+// [p0, p0 + depth) x columns [j0, j0 + width)
+void maskRightPanels(Triangle triangle, int p0, int depth, int j0, int width) {
+    if (blockInside(triangle, p0, p0 + depth, j0, j0 + width)) {
+        return;
+    }
+    for (int c = 0; c < width; ++c) {
+        double* dst = &packedB[static_cast<size_t>(c / kMicroCols) * kMicroCols * depth + c % kMicroCols];
+        for (int q = 0; q < depth; ++q) {
+            if (outside(triangle, p0 + q, j0 + c)) {
+                dst[static_cast<size_t>(q) * kMicroCols] = 0.0;
+            }
+        }
+    }
+}
+
+// Run the tasks on the shared pool, heaviest first so the dynamic schedule
+// ends with small tiles and the threads finish together
+void runTileTasks(const TileProblem& problem, std::vector<TileTask>& tasks, Matrix& result) {
+    std::stable_sort(tasks.begin(), tasks.end(),
+                     [](const TileTask& a, const TileTask& b) { return a.work > b.work; });
+
+    int m = result.getRows();
+    int n = result.getCols();
+    sharedThreadPool().parallelFor(0, static_cast<int>(tasks.size()), 1, [&](int lo, int hi) {
+        for (int t = lo; t < hi; ++t) {
+            const TileTask& task = tasks[t];
+            TRACE_SCOPE_ARG("triangularTile", t);
+            int height = std::min(kTile, m - task.i0);
+            int width = std::min(kTile, n - task.j0);
+
+            for (int p = task.p0; p < task.p1; p += kDepth) {
+                int depth = std::min(kDepth, task.p1 - p);
+                packRightPanels(problem.B, p, depth, task.j0, width, packedB);
+                packLeftPanels(problem.A, task.i0, height, p, depth, packedA);
+                if (problem.maskA) {
+                    maskLeftPanels(problem.triangle, task.i0, height, p, depth);
+                }
+                if (problem.maskB) {
+                    maskRightPanels(problem.triangle, p, depth, task.j0, width);
+                }
+
+                for (int jr = 0; jr < width; jr += kMicroCols) {
+                    const double* panelB = &packedB[static_cast<size_t>(jr / kMicroCols) * kMicroCols * depth];
+                    int cols = std::min(kMicroCols, width - jr);
+                    for (int ir = 0; ir < height; ir += kMicroRows) {
+                        int rows = std::min(kMicroRows, height - ir);
+                        int row0 = task.i0 + ir;
+                        int col0 = task.j0 + jr;
+                        if (problem.triangleOnly &&
+                            (problem.triangle == Triangle::Lower ? col0 > row0 + rows - 1 : col0 + cols - 1 < row0)) {
+                            continue; // Micro-tile lies entirely in the unneeded triangle
+                        }
+                        const double* panelA = &packedA[static_cast<size_t>(ir / kMicroRows) * kMicroRows * depth];
+                        simd_gemm_packed_ab(rows, cols, depth, panelA, panelB, result.rowData(row0) + col0, n);
+                    }
+                }
+            }
+        }
+    });
+}
+
+void checkTriangular(const MatrixView& T) {
+    if (T.getRows() != T.getCols()) {
+        throw std::invalid_argument("Triangular matrix must be square.");
+    }
+}
+
+} // namespace
+
+// Symmetric rank-k product over the tiles of one triangle
+Matrix syrkMultiply(const MatrixView& A, Triangle triangle, bool mirror) {
+    int n = A.getRows();
+    int k = A.getCols();
+    Matrix result(n, n);
+    if (n == 0 || k == 0) {
+        return result;
+    }
+
+    TileProblem problem(A, A.transpose(), triangle);
+    problem.triangleOnly = true;
+
+    int tiles = (n + kTile - 1) / kTile;
+    std::vector<TileTask> tasks;
+    for (int ti = 0; ti < tiles; ++ti) {
+        int first = triangle == Triangle::Lower ? 0 : ti;
+        int last = triangle == Triangle::Lower ? ti : tiles - 1;
+        for (int tj = first; tj <= last; ++tj) {
+            TileTask task = {ti * kTile, tj * kTile, 0, k, 0.0};
+            double area = static_cast<double>(std::min(kTile, n - task.i0)) * std::min(kTile, n - task.j0);
+            task.work = (ti == tj ? area / 2 : area) * k;
+            tasks.push_back(task);
+        }
+    }
+    runTileTasks(problem, tasks, result);
+
+    // Diagonal micro-tiles also wrote some elements of the other triangle
+    for (int i = 0; i < n; ++i) {
+        double* row = result.rowData(i);
+        int begin = triangle == Triangle::Lower ? i + 1 : 0;
+        int end = triangle == Triangle::Lower ? n : i;
+        for (int j = begin; j < end; ++j) {
+            row[j] = mirror ? result.rowData(j)[i] : 0.0;
+        }
+    }
+    return result;
+}
+
+// C = T * B, skipping the zero triangle of T
+Matrix triangularMultiply(const MatrixView& T, Triangle triangle, const MatrixView& B) {
+    checkTriangular(T);
+    if (T.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
+    int m = T.getRows();
+    int n = B.getCols();
+    Matrix result(m, n);
+    if (m == 0 || n == 0) {
+        return result;
+    }
+
+    TileProblem problem(T, B, triangle);
+    problem.maskA = true;
+
+    // Rows [i0, i0 + height) of T are non-zero in columns [0, i0 + height)
+    // (lower) or [i0, m) (upper)
+    std::vector<TileTask> tasks;
+    for (int i0 = 0; i0 < m; i0 += kTile) {
+        int height = std::min(kTile, m - i0);
+        int p0 = triangle == Triangle::Lower ? 0 : i0;
+        int p1 = triangle == Triangle::Lower ? i0 + height : m;
+        for (int j0 = 0; j0 < n; j0 += kTile) {
+            TileTask task = {i0, j0, p0, p1, static_cast<double>(height) * std::min(kTile, n - j0) * (p1 - p0)};
+            tasks.push_back(task);
+        }
+    }
+    runTileTasks(problem, tasks, result);
+    return result;
+}
+
+// C = B * T, skipping the zero triangle of T
+Matrix triangularMultiplyRight(const MatrixView& B, const MatrixView& T, Triangle triangle) {
+    checkTriangular(T);
+    if (B.getCols() != T.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+
+    int m = B.getRows();
+    int n = T.getCols();
+    Matrix result(m, n);
+    if (m == 0 || n == 0) {
+        return result;
+    }
+
+    TileProblem problem(B, T, triangle);
+    problem.maskB = true;
+
+    // Columns [j0, j0 + width) of T are non-zero in rows [j0, n) (lower) or
+    // [0, j0 + width) (upper)
+    std::vector<TileTask> tasks;
+    for (int j0 = 0; j0 < n; j0 += kTile) {
+        int width = std::min(kTile, n - j0);
+        int p0 = triangle == Triangle::Lower ? j0 : 0;
+        int p1 = triangle == Triangle::Lower ? n : j0 + width;
+        for (int i0 = 0; i0 < m; i0 += kTile) {
+            TileTask task = {i0, j0, p0, p1, static_cast<double>(std::min(kTile, m - i0)) * width * (p1 - p0)};
+            tasks.push_back(task);
+        }
+    }
+    runTileTasks(problem, tasks, result);
+    return result;
+}
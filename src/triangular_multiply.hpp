@@ -0,0 +1,25 @@
+#ifndef TRIANGULAR_MULTIPLY_HPP
+#define TRIANGULAR_MULTIPLY_HPP
+
+#include "matrix.hpp"
+
+// Triangle of a square matrix (the diagonal belongs to both)
+enum class Triangle {
+    Lower,
+    Upper
+};
+
+// Symmetric rank-k product C = A * Aᵀ (n x n for an n x k A). Only the output
+// tiles of one triangle are computed, about half the flops of a general
+// multiply; with mirror the other triangle is filled by symmetry, otherwise it
+// is left zero. Pass A.transpose() for Aᵀ * A.
+Matrix syrkMultiply(const MatrixView& A, Triangle triangle = Triangle::Lower, bool mirror = true);
+
+// C = T * B for a square triangular T. Elements of T outside the triangle are
+// treated as zero and never read, so a packed LU factor can be passed as is.
+Matrix triangularMultiply(const MatrixView& T, Triangle triangle, const MatrixView& B);
+
+// C = B * T for a square triangular T (same rules as triangularMultiply)
+Matrix triangularMultiplyRight(const MatrixView& B, const MatrixView& T, Triangle triangle);
+
+#endif // TRIANGULAR_MULTIPLY_HPP
@@ -0,0 +1,138 @@
+#include "verification.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Per-thread generator for projections and sampling
+std::mt19937_64& generator() {
+    thread_local std::mt19937_64 engine(std::random_device{}());
+    return engine;
+}
+
+// y = M * x and yAbs = |M| * |x| for a dense matrix
+void multiplyVector(const Matrix& M, const std::vector<double>& x, const std::vector<double>& xAbs,
+                    std::vector<double>& y, std::vector<double>& yAbs) {
+    int cols = M.getCols();
+    y.assign(M.getRows(), 0.0);
+    yAbs.assign(M.getRows(), 0.0);
+    for (int i = 0; i < M.getRows(); ++i) {
+        const double* row = M.rowData(i);
+        double sum = 0.0;
+        double sumAbs = 0.0;
+        for (int j = 0; j < cols; ++j) {
+            sum += row[j] * x[j];
+            sumAbs += std::fabs(row[j]) * xAbs[j];
+        }
+        y[i] = sum;
+        yAbs[i] = sumAbs;
+    }
+}
+
+// y = M * x and yAbs = |M| * |x| for a CSR matrix
+void multiplyVector(const CSRMatrix& M, const std::vector<double>& x, const std::vector<double>& xAbs,
+                    std::vector<double>& y, std::vector<double>& yAbs) {
+    y.assign(M.getRows(), 0.0);
+    yAbs.assign(M.getRows(), 0.0);
+    for (int i = 0; i < M.getRows(); ++i) {
+        double sum = 0.0;
+        double sumAbs = 0.0;
+        for (int p = M.rowPtr[i]; p < M.rowPtr[i + 1]; ++p) {
+            sum += M.values[p] * x[M.colIndices[p]];
+            sumAbs += std::fabs(M.values[p]) * xAbs[M.colIndices[p]];
+        }
+        y[i] = sum;
+        yAbs[i] = sumAbs;
+    }
+}
+
+template <typename MatrixA, typename MatrixBC>
+VerifyResult verify(const MatrixA& A, const MatrixBC& B, const MatrixBC& C, const VerifyOptions& options) {
+    if (A.getCols() != B.getRows()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+    if (C.getRows() != A.getRows() || C.getCols() != B.getCols()) {
+        throw std::invalid_argument("Result matrix dimensions do not match.");
+    }
+
+    VerifyResult result;
+    result.checked = false;
+    result.passed = true;
+    result.worstRow = -1;
+    result.worstError = 0.0;
+    result.worstAllowed = 0.0;
+
+    std::mt19937_64& rng = generator();
+    if (options.samplingRate < 1.0 &&
+        std::uniform_real_distribution<double>(0.0, 1.0)(rng) >= options.samplingRate) {
+        return result;
+    }
+    result.checked = true;
+
+    // Rounding errors of a length-k dot product grow like sqrt(k) in practice
+    // (k in the worst case); both sides of the comparison add one more
+    // matrix-vector product over the columns of B
+    double terms = static_cast<double>(A.getCols()) + B.getCols() + 2.0;
+    double tolerance = options.tolerance > 0.0 ? options.tolerance
+                                               : 16.0 * std::sqrt(terms) * DBL_EPSILON;
+
+    std::uniform_real_distribution<double> entry(-1.0, 1.0);
+    std::vector<double> r(B.getCols()), rAbs(B.getCols());
+    std::vector<double> br, brAbs, abr, abrAbs, cr, crAbs;
+    double worstRatio = -1.0;
+    for (int trial = 0; trial < options.trials; ++trial) {
+        for (size_t j = 0; j < r.size(); ++j) {
+            r[j] = entry(rng);
+            rAbs[j] = std::fabs(r[j]);
+        }
+        multiplyVector(B, r, rAbs, br, brAbs);
+        multiplyVector(A, br, brAbs, abr, abrAbs);
+        multiplyVector(C, r, rAbs, cr, crAbs);
+
+        for (int i = 0; i < C.getRows(); ++i) {
+            double error = std::fabs(abr[i] - cr[i]);
+            double allowed = tolerance * (abrAbs[i] + crAbs[i]);
+            double ratio = allowed > 0.0 ? error / allowed : (error > 0.0 ? INFINITY : 0.0);
+            if (std::isnan(ratio)) {
+                ratio = INFINITY;
+            }
+            if (ratio > worstRatio) {
+                worstRatio = ratio;
+                result.worstRow = i;
+                result.worstError = error;
+                result.worstAllowed = allowed;
+            }
+            if (!(error <= allowed)) { // Also catches NaN
+                result.passed = false;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+// Default settings: two projections on every call, automatic tolerance
+VerifyOptions::VerifyOptions() : trials(2), samplingRate(1.0), tolerance(0.0) {}
+
+// Freivalds check for dense operands
+VerifyResult verifyProduct(const Matrix& A, const Matrix& B, const Matrix& C,
+                           const VerifyOptions& options) {
+    return verify(A, B, C, options);
+}
+
+// Freivalds check for CSR operands
+VerifyResult verifyProduct(const CSRMatrix& A, const CSRMatrix& B, const CSRMatrix& C,
+                           const VerifyOptions& options) {
+    return verify(A, B, C, options);
+}
+
+// Freivalds check for a CSR A with dense B and C
+VerifyResult verifyProduct(const CSRMatrix& A, const Matrix& B, const Matrix& C,
+                           const VerifyOptions& options) {
+    return verify(A, B, C, options);
+}
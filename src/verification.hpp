@@ -0,0 +1,36 @@
+#ifndef VERIFICATION_HPP
+#define VERIFICATION_HPP
+
+#include "csr_matrix.hpp"
+#include "matrix.hpp"
+
+// Settings of a randomized product check
+struct VerifyOptions {
+    VerifyOptions();
+
+    int trials;          // Independent random projections per check
+    double samplingRate; // Fraction of calls that are actually checked (0 to 1)
+    double tolerance;    // Allowed relative error; 0 derives it from the inner dimension
+};
+
+// Outcome of a product check
+struct VerifyResult {
+    bool checked;        // False when the call was skipped by sampling
+    bool passed;         // True when checked and every row was within tolerance (or not checked)
+    int worstRow;        // Row with the largest error relative to its bound (-1 if none)
+    double worstError;   // |(A * (B * r))_i - (C * r)_i| at worstRow
+    double worstAllowed; // Error bound at worstRow
+};
+
+// Freivalds check of C == A * B: for random vectors r, compares A * (B * r)
+// with C * r in O(n^2) per trial. Each row's bound scales with the magnitudes
+// of the terms that produced it, so rounding differences between engines are
+// accepted while wrong elements are not.
+VerifyResult verifyProduct(const Matrix& A, const Matrix& B, const Matrix& C,
+                           const VerifyOptions& options = VerifyOptions());
+VerifyResult verifyProduct(const CSRMatrix& A, const CSRMatrix& B, const CSRMatrix& C,
+                           const VerifyOptions& options = VerifyOptions());
+VerifyResult verifyProduct(const CSRMatrix& A, const Matrix& B, const Matrix& C,
+                           const VerifyOptions& options = VerifyOptions());
+
+#endif // VERIFICATION_HPP